@@ -6,6 +6,7 @@
 #include "Engine/Renderer/Camera.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 
 // Globally defined renderer
@@ -15,6 +16,7 @@ AudioSystem* g_AudioSystem = nullptr;
 InputSystem* g_InputSystem = nullptr;
 RenderContext* g_Renderer = nullptr;
 Game* g_GameInstance = nullptr;
+FrameArena* g_FrameArena = nullptr;
 
 //-----------------------------------------------------------------------------
 App::App()
@@ -40,6 +42,8 @@ void App::Startup()
     g_Renderer = new RenderContext();
     g_Renderer->Startup( g_Window );
 
+    g_FrameArena = new FrameArena( FRAME_ARENA_BYTES );
+
     // Initialize the Game
     g_GameInstance = new Game();
     g_GameInstance->Startup();
@@ -55,6 +59,9 @@ void App::Shutdown()
     delete g_GameInstance;
     g_GameInstance = nullptr;
 
+    delete g_FrameArena;
+    g_FrameArena = nullptr;
+
     g_Renderer->Shutdown();
     delete g_Renderer;
     g_Renderer = nullptr;
@@ -79,6 +86,8 @@ void App::RunFrame()
     constexpr float MAX_DELTA_SECONDS = 1.f / 10.f;
     if ( deltaSeconds > MAX_DELTA_SECONDS ) { deltaSeconds = MAX_DELTA_SECONDS; }
 
+    g_FrameArena->Reset();
+
     BeginFrame(); // For all engine systems, before game updates
     Update( deltaSeconds );
     Render();
@@ -7,6 +7,7 @@
 #include "Engine/Renderer/Sprite/SpriteSheet.hpp"
 
 #include "Game/AssetManagers/TextureManager.hpp"
+#include "Game/FrameArena.hpp"
 
 #include "Engine/Renderer/Mesh/MeshUtils.hpp"
 
@@ -20,13 +21,7 @@ Bolder::Bolder( Game* gameInstance,
 
     m_EntityType = ENTITY_BOLDER;
 
-    m_OverlapsTiles = true;
-    m_IsPushedByWalls = true;
-    m_OverlapsEntities = true;
-    m_IsFixed = false;
-    m_IsPushedByEntities = true;
-    m_DoesPushEntities = true;
-    m_IsHitByBullets = true;
+    SetPhysicsFlagsFromType();
 
     m_Sprite = &g_Renderer->CreateOrGetSpriteSheetFromFile( SPRITE_SHEET_EXTRAS, IntVec2( 4, 4 ) )->GetSpriteDefinition(3);
 }
@@ -37,7 +32,7 @@ void Bolder::Create()
 
 void Bolder::Render() const
 {
-    std::vector<VertexMaster> bolderVisual;
+    std::vector<VertexMaster>& bolderVisual = g_FrameArena->AllocateVertexList();
     Vec2 uvMin = Vec2::ZERO;
     Vec2 uvMax = Vec2::ZERO;
     m_Sprite->GetUVs( uvMin, uvMax );
@@ -48,7 +43,7 @@ void Bolder::Render() const
                             uvMin, 
                             uvMax );
 
-    TransformVertexArray( bolderVisual, static_cast<Vec2>(m_Position), m_AngleDegrees, 1.f );
+    TransformVertexArray( bolderVisual, static_cast<Vec2>(GetPosition()), GetAngleDegrees(), 1.f );
     g_Renderer->BindTexture( GetTexture() );
     g_Renderer->DrawVertexArray( bolderVisual );
 }
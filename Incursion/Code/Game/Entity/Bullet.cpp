@@ -3,6 +3,7 @@
 #include "Engine/Core/Utils/VectorPcuUtils.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 
+#include "Game/FrameArena.hpp"
 #include "Game/Map/Map.hpp"
 
 #include "Engine/Renderer/Mesh/MeshUtils.hpp"
@@ -23,13 +24,7 @@ Bullet::Bullet( Game* gameInstance,
 
     m_Texture = g_Renderer->CreateOrGetTextureFromFile( "Data/Sprites/Bullet.png" );
 
-    m_OverlapsTiles = true;
-    m_IsPushedByWalls = false;
-    m_OverlapsEntities = true;
-    m_IsFixed = false;
-    m_IsPushedByEntities = false;
-    m_DoesPushEntities = false;
-    m_IsHitByBullets = false;
+    SetPhysicsFlagsFromType();
 }
 
 void Bullet::Create()
@@ -48,13 +43,13 @@ void Bullet::Render() const
 {
     if ( m_IsDead ) { return; }
 
-    std::vector<VertexMaster> visual;
+    std::vector<VertexMaster>& visual = g_FrameArena->AllocateVertexList();
     Vec2 minUV = Vec2::ZERO;
     Vec2 maxUV = Vec2::ONE;
 
     AppendAABB2( visual, AABB2::UNIT_AROUND_ZERO, Rgba8::WHITE );
 
-    TransformVertexArray( visual, static_cast<Vec2>(m_Position), m_AngleDegrees, static_cast<Vec2>(m_Scale) );
+    TransformVertexArray( visual, static_cast<Vec2>(GetPosition()), GetAngleDegrees(), static_cast<Vec2>(m_Scale) );
 
     g_Renderer->BindTexture( GetTexture() );
     g_Renderer->DrawVertexArray( visual );
@@ -65,17 +60,28 @@ void Bullet::Die()
     m_IsDead = true;
     m_IsGarbage = true;
 
-    m_CurrentMap->SpawnNewExplosion( m_Position, .5f, Vec3( .25f, .25f, .25f ) );
+    m_CurrentMap->RequestSpawnExplosion( GetPosition(), .5f, Vec3( .25f, .25f, .25f ) );
 }
 
 void Bullet::Destroy()
 {
 }
 
+void Bullet::Reuse( const Vec3& position, EntityType type, Faction faction )
+{
+    ReuseAt( position );
+
+    m_EntityType = type;
+    m_EntityFaction = faction;
+    m_Health = 1;
+
+    SetPhysicsFlagsFromType();
+}
+
 void Bullet::SetBulletDireciton( const Vec2& forward )
 {
     float angle = forward.GetAngleDegrees();
-    m_AngleDegrees = angle;
+    SetAngleDegrees( angle );
 
-    m_Velocity = static_cast<Vec3>(forward * BULLET_MAX_VELOCITY);
+    SetVelocity( static_cast<Vec3>(forward * BULLET_MAX_VELOCITY) );
 }
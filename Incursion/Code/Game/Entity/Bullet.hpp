@@ -17,5 +17,8 @@ public:
     virtual void Die() override;
     virtual void Destroy() override;
 
+    // Restarts a pooled bullet as if it was just constructed
+    void Reuse( const Vec3& position, EntityType type, Faction faction );
+
     void SetBulletDireciton( const Vec2& forward );
 };
\ No newline at end of file
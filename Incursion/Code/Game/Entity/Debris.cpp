@@ -5,7 +5,9 @@
 #include "Engine/Renderer/RenderContext.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
+#include "Game/Map/Map.hpp"
 
 Debris::~Debris()
 {
@@ -13,6 +15,8 @@ Debris::~Debris()
 
 void Debris::Create()
 {
+    m_Visual.clear();
+
     // Define the outer vertex based on n number of equal degree triangles
     float degreesPerCorner = 360.f / ( float) m_TriangleCount;
     float length = g_GameInstance->GetRng()->FloatInRange( m_InnerRadius,
@@ -87,10 +91,11 @@ void ChangeVertexArray( std::vector<VertexMaster>& visual, const Rgba8& color )
 
 void Debris::Render() const
 {
-    std::vector<VertexMaster> visualCopy( m_Visual );
+    std::vector<VertexMaster>& visualCopy = g_FrameArena->AllocateVertexList();
+    visualCopy = m_Visual;
     ChangeVertexArray( visualCopy, m_DebrisColor );
 
-    TransformVertexArray( visualCopy, static_cast<Vec2>(m_Position), m_AngleDegrees, static_cast<Vec2>(m_Scale) );
+    TransformVertexArray( visualCopy, static_cast<Vec2>(GetPosition()), GetAngleDegrees(), static_cast<Vec2>(m_Scale) );
 
     g_Renderer->BindTexture( m_Texture );
     g_Renderer->DrawVertexArray( visualCopy );
@@ -126,8 +131,8 @@ Debris::Debris( Game* gameInstance,
     , m_InnerRadius( innerRadius )
     , m_OuterRadius( outerRadius )
 {
-    m_Velocity = initialVelocity;
-    m_AngularVelocity = angularVelocity;
+    SetVelocity( initialVelocity );
+    SetAngularVelocity( angularVelocity );
 
     SetUniformScale(scale);
 
@@ -138,6 +143,36 @@ Debris::Debris( Game* gameInstance,
     m_EntityType = ENTITY_DEBRIS;
 }
 
+void Debris::Reuse( const Vec3& startingPosition,
+                    const Vec3& initialVelocity,
+                    float angularVelocity,
+                    float scale,
+                    float lifeSpan,
+                    const Rgba8& color,
+                    bool fadeOut,
+                    Texture* texture,
+                    int triangleCount,
+                    float innerRadius,
+                    float outerRadius )
+{
+    ReuseAt( startingPosition );
+
+    m_LifeSpan = lifeSpan;
+    m_FadeOut = fadeOut;
+    m_DebrisColor = color;
+    m_InnerRadius = innerRadius;
+    m_OuterRadius = outerRadius;
+
+    SetVelocity( initialVelocity );
+    SetAngularVelocity( angularVelocity );
+
+    SetUniformScale( scale );
+
+    m_Texture = texture;
+
+    m_TriangleCount = triangleCount;
+}
+
 DebrisType DebrisType::UniformDebrisExplosion( Game* gameInstance, 
                                                Map* currentMap, 
                                                const Vec3& centerPointSpawn, 
@@ -295,19 +330,38 @@ Debris* DebrisType::BuildDebris()
                                                            m_UpperScaleRange
     );
 
-    Debris* newDebris = new Debris( m_GameInstance,
-                                    m_CurrentMap,
-                                    spawnPosition,
-                                    spawnVelocity,
-                                    spawnAngularVelocity,
-                                    spawnScale,
-                                    m_LifeSpan,
-                                    m_InitialColor,
-                                    m_FadeOut,
-                                    m_Texture,
-                                    m_TriangleCount,
-                                    m_InnerRadius,
-                                    m_OuterRadius );
+    // Falls back to the heap once the map's pool is used up
+    Debris* newDebris = m_CurrentMap->AcquirePooledDebris();
+    if( newDebris != nullptr )
+    {
+        newDebris->Reuse( spawnPosition,
+                          spawnVelocity,
+                          spawnAngularVelocity,
+                          spawnScale,
+                          m_LifeSpan,
+                          m_InitialColor,
+                          m_FadeOut,
+                          m_Texture,
+                          m_TriangleCount,
+                          m_InnerRadius,
+                          m_OuterRadius );
+    }
+    else
+    {
+        newDebris = new Debris( m_GameInstance,
+                                m_CurrentMap,
+                                spawnPosition,
+                                spawnVelocity,
+                                spawnAngularVelocity,
+                                spawnScale,
+                                m_LifeSpan,
+                                m_InitialColor,
+                                m_FadeOut,
+                                m_Texture,
+                                m_TriangleCount,
+                                m_InnerRadius,
+                                m_OuterRadius );
+    }
     newDebris->Create();
 
     return newDebris;
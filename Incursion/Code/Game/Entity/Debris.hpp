@@ -11,6 +11,7 @@ struct VertexMaster;
 class Debris: public Entity
 {
     friend class DebrisType;
+    friend class Map;
 
 public:
     ~Debris();
@@ -46,6 +47,19 @@ private:
             float innerRadius,
             float outerRadius) ;
 
+    // Restarts a pooled piece of debris with the constructor's parameters
+    void Reuse( const Vec3& startingPosition,
+                const Vec3& initialVelocity,
+                float angularVelocity,
+                float scale,
+                float lifeSpan,
+                const Rgba8& color,
+                bool fadeOut,
+                Texture* texture,
+                int triangleCount,
+                float innerRadius,
+                float outerRadius );
+
 };
 
 class DebrisType
@@ -9,7 +9,10 @@
 #include "Engine/Renderer/Sprite/SpriteDefinition.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
+#include "Game/Entity/EntityKinematics.hpp"
+#include "Game/Entity/EntityPhysics.hpp"
 #include "Game/Map/Map.hpp"
 
 
@@ -22,8 +25,9 @@ Entity::Entity( Game* gameInstance,
                 const Vec3& startingPositon )
     : m_GameInstance( gameInstance )
     , m_CurrentMap( currentMap )
-    , m_Position( startingPositon )
 {
+    m_Kinematics = &currentMap->GetEntityKinematics();
+    m_KinematicsSlot = m_Kinematics->AddSlot( startingPositon );
 }
 
 Entity::Entity( Game* gameInstance,
@@ -32,9 +36,10 @@ Entity::Entity( Game* gameInstance,
                 Faction faction )
     : m_GameInstance( gameInstance )
     , m_CurrentMap( currentMap )
-    , m_Position( startingPosition )
     , m_EntityFaction( faction )
 {
+    m_Kinematics = &currentMap->GetEntityKinematics();
+    m_KinematicsSlot = m_Kinematics->AddSlot( startingPosition );
 }
 
 //-------------------------------------------------------------------------------
@@ -43,80 +48,18 @@ Entity::~Entity()
     // DO NOTHING
 }
 
+// Lists whose entity types can never interact are skipped as a whole
 bool Entity::DoEntityListsOverlap( EntityListIndex l1, EntityListIndex l2 )
 {
-    // Bullets do not overlap
-    if ( l1 == ENTITY_BULLET_ALLIED && l2 == ENTITY_BULLET_ENEMY ||
-         l2 == ENTITY_BULLET_ALLIED && l1 == ENTITY_BULLET_ENEMY )
-    {
-        return false;
-    }
-
-    // Allied bullets do not overlap allied tanks or turrets
-    if ( (l1 == ENTITY_BULLET_ALLIED && (l2 == ENTITY_ALLIED_TANK ||
-                                          l2 == ENTITY_ALLIED_TURRET)) ||
-                                          (l2 == ENTITY_BULLET_ALLIED && (l1 == ENTITY_ALLIED_TANK ||
-                                                                           l1 == ENTITY_ALLIED_TURRET)) )
-    {
-        return false;
-    }
-
-    // Enemy bullets do not overlap enemy tanks or turrets
-    if ( (l1 == ENTITY_BULLET_ENEMY && (l2 == ENTITY_ENEMY_TANK ||
-                                         l2 == ENTITY_ENEMY_TURRET)) ||
-                                         (l2 == ENTITY_BULLET_ENEMY && (l1 == ENTITY_ENEMY_TANK ||
-                                                                         l1 == ENTITY_ENEMY_TURRET)) )
-    {
-        return false;
-    }
-
-    return true;
+    return ENTITY_COLLISION_MATRIX.overlapTypes[ l1 ][ l2 ] != EntityOverlapType::NONE;
 }
 
 EntityOverlapType Entity::OverlapsWith( const Entity* const& entity1, const Entity* const& entity2 )
 {
     // Entities cannot overlap with themselves
     if ( entity1 == entity2 ) { return EntityOverlapType::NONE; }
-    // Entities cannot overlap with others that do not overlap with entities
-    if ( !entity1->m_OverlapsEntities || !entity2->m_OverlapsEntities )
-    {
-        return EntityOverlapType::NONE;
-    }
-
-    EntityType entityType1 = entity1->GetEntityType();
-    EntityType entityType2 = entity2->GetEntityType();
-
-    // If entities do not get hit by bullets
-    if ( !entity1->m_IsHitByBullets && (entityType2 == ENTITY_BULLET_ALLIED ||
-                                         entityType2 == ENTITY_BULLET_ENEMY) )
-    {
-        return EntityOverlapType::NONE;
-    }
-    if ( !entity2->m_IsHitByBullets && (entityType1 == ENTITY_BULLET_ALLIED ||
-                                         entityType1 == ENTITY_BULLET_ENEMY) )
-    {
-        return EntityOverlapType::NONE;
-    }
-
-    if ( entity1->DoesPushEntities() && entity1->IsPushedByEntities() &&
-         entity2->DoesPushEntities() && entity2->IsPushedByEntities() )
-    {
-        return EntityOverlapType::PUSH_PUSH;
-    }
-
-    if ( entity1->DoesPushEntities() && entity2->IsPushedByEntities() && !entity1->IsFixed() ||
-         entity2->DoesPushEntities() && entity1->IsPushedByEntities() && !entity2->IsFixed() )
-    {
-        return EntityOverlapType::PUSH_NO_PUSH;
-    }
 
-    if ( entity1->DoesPushEntities() && entity2->IsFixed()  && !entity1->IsFixed() ||
-         entity2->DoesPushEntities() && entity1->IsFixed()  && !entity2->IsFixed() )
-    {
-        return EntityOverlapType::PUSH_FIXED;
-    }
-
-    return EntityOverlapType::OVERLAP_ONLY;
+    return ENTITY_COLLISION_MATRIX.overlapTypes[ entity1->GetEntityType() ][ entity2->GetEntityType() ];
 }
 
 bool Entity::OverlapsWithTiles( const Entity* const& entity )
@@ -133,32 +76,28 @@ void Entity::Update( float deltaSeconds )
 {
     m_Age += deltaSeconds;
 
-    m_Velocity *= m_VelocityModifier;
-    m_Position += m_Velocity * deltaSeconds;
-    m_Velocity += m_Acceleration * deltaSeconds;
-
-    m_AngleDegrees += m_AngularVelocity * deltaSeconds;
-    m_AngularVelocity += m_AngularAcceleration * deltaSeconds;
-
-    m_VelocityModifier = 1.f;
+    // Integrated with the rest of the map in Map::UpdateEntities
+    m_Kinematics->Step( m_KinematicsSlot, deltaSeconds );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::DebugRender() const
 {
-    std::vector<VertexMaster> debugVisual;
+    const Vec3 position = GetPosition();
+    const Vec3 velocity = GetVelocity();
+    std::vector<VertexMaster>& debugVisual = g_FrameArena->AllocateVertexList();
     // Draw debug velocity
-    AppendLine( debugVisual, LineSeg2D(Vec2( m_Position.x, m_Position.y ),
-                          Vec2( m_Position.x, m_Position.y ) +
-                          Vec2( m_Velocity.x, m_Velocity.y ) ),
+    AppendLine( debugVisual, LineSeg2D(Vec2( position.x, position.y ),
+                          Vec2( position.x, position.y ) +
+                          Vec2( velocity.x, velocity.y ) ),
                           Rgba8( 255, 255, 0 ), .05f );
            // Draw Physics circle
-    AppendDiscPerimeter(debugVisual, Disc( Vec2( m_Position.x, m_Position.y ),
+    AppendDiscPerimeter(debugVisual, Disc( Vec2( position.x, position.y ),
                                 m_PhysicsRadius * m_Scale.x ),
                           Rgba8::CYAN,
                           .025f );
          // Draw Cosmetic circle
-    AppendDiscPerimeter( debugVisual, Disc( Vec2( m_Position.x, m_Position.y ),
+    AppendDiscPerimeter( debugVisual, Disc( Vec2( position.x, position.y ),
                                 m_CosmeticRadius * m_Scale.x ),
                           Rgba8::MAGENTA,
                           .025f );
@@ -174,25 +113,30 @@ void Entity::Destroy()
 //-------------------------------------------------------------------------------
 const Vec3 Entity::GetPosition() const
 {
-    return m_Position;
+    return m_Kinematics->GetPosition( m_KinematicsSlot );
 }
 
 //-------------------------------------------------------------------------------
 const Vec3 Entity::GetVelocity() const
 {
-    return m_Velocity;
+    return m_Kinematics->GetVelocity( m_KinematicsSlot );
+}
+
+const Vec3 Entity::GetPreviousPosition() const
+{
+    return m_Kinematics->GetPreviousPosition( m_KinematicsSlot );
 }
 
 //-------------------------------------------------------------------------------
 const Vec3 Entity::GetAcceleration() const
 {
-    return m_Acceleration;
+    return m_Kinematics->GetAcceleration( m_KinematicsSlot );
 }
 
 //-------------------------------------------------------------------------------
 const Vec3 Entity::GetForwardVector() const
 {
-    return Vec3::MakeFromPolarDegreesXY( m_AngleDegrees );
+    return Vec3::MakeFromPolarDegreesXY( GetAngleDegrees() );
 }
 
 const Vec3 Entity::GetScale() const
@@ -203,24 +147,34 @@ const Vec3 Entity::GetScale() const
 //-------------------------------------------------------------------------------
 float Entity::GetAngleDegrees() const
 {
-    return m_AngleDegrees;
+    return m_Kinematics->GetAngleDegrees( m_KinematicsSlot );
 }
 
 //-------------------------------------------------------------------------------
 float Entity::GetAngularVelocity() const
 {
-    return m_AngularVelocity;
+    return m_Kinematics->GetAngularVelocity( m_KinematicsSlot );
 }
 
 //-------------------------------------------------------------------------------
 float Entity::GetAngularAcceleration() const
 {
-    return m_AngularAcceleration;
+    return m_Kinematics->GetAngularAcceleration( m_KinematicsSlot );
 }
 
 const Disc Entity::GetEntityPhysicsDisc() const
 {
-    return Disc( static_cast<Vec2>(m_Position), m_PhysicsRadius * m_Scale.x );
+    return Disc( static_cast<Vec2>(GetPosition()), m_PhysicsRadius * m_Scale.x );
+}
+
+float Entity::GetPhysicsRadius() const
+{
+    return m_PhysicsRadius * m_Scale.x;
+}
+
+float Entity::GetCosmeticRadius() const
+{
+    return m_CosmeticRadius * m_Scale.x;
 }
 
 const Texture* Entity::GetTexture() const
@@ -263,7 +217,12 @@ Faction Entity::GetEntityFaction() const
 
 float Entity::GetVelocityModifier() const
 {
-    return m_VelocityModifier;
+    return m_Kinematics->GetVelocityModifier( m_KinematicsSlot );
+}
+
+float Entity::GetMaxSpeed() const
+{
+    return m_Kinematics->GetMaxSpeed( m_KinematicsSlot );
 }
 
 //-------------------------------------------------------------------------------
@@ -283,6 +242,11 @@ bool Entity::IsDead() const
     return m_IsDead;
 }
 
+const EntityHandle& Entity::GetHandle() const
+{
+    return m_Handle;
+}
+
 //-------------------------------------------------------------------------------
 // bool Entity::IsOffscreen() const
 // {
@@ -341,46 +305,56 @@ bool Entity::IsHitByBullets() const
     return m_IsHitByBullets;
 }
 
+bool Entity::OverlapsEntities() const
+{
+    return m_OverlapsEntities;
+}
+
+bool Entity::UsesSweptCollision() const
+{
+    return m_UsesSweptCollision;
+}
+
 const Vec3 Entity::GetPhysicsDiscNormalAt( const Vec3& hitPosition )
 {
-    float angle = (m_Position - hitPosition).GetAngleAboutZDegrees();
+    float angle = (GetPosition() - hitPosition).GetAngleAboutZDegrees();
     return Vec3::MakeFromPolarDegreesXY(angle);
 }
 
 //-------------------------------------------------------------------------------
 void Entity::SetPosition( const Vec3& newPosition )
 {
-    m_Position = newPosition;
+    m_Kinematics->SetPosition( m_KinematicsSlot, newPosition );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::AddPosition( const Vec3& deltaPosition )
 {
-    m_Position += deltaPosition;
+    m_Kinematics->SetPosition( m_KinematicsSlot, GetPosition() + deltaPosition );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::SetVelocity( const Vec3& newVelocity )
 {
-    m_Velocity = newVelocity;
+    m_Kinematics->SetVelocity( m_KinematicsSlot, newVelocity );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::AddVelocity( const Vec3& deltaVelocity )
 {
-    m_Velocity += deltaVelocity;
+    m_Kinematics->SetVelocity( m_KinematicsSlot, GetVelocity() + deltaVelocity );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::SetAcceleration( const Vec3& newAcceleration )
 {
-    m_Acceleration = newAcceleration;
+    m_Kinematics->SetAcceleration( m_KinematicsSlot, newAcceleration );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::AddAcceleration( const Vec3& deltaAcceleration )
 {
-    m_Acceleration += deltaAcceleration;
+    m_Kinematics->SetAcceleration( m_KinematicsSlot, GetAcceleration() + deltaAcceleration );
 }
 
 void Entity::SetScale( const Vec3& newScale )
@@ -393,6 +367,19 @@ void Entity::AddScale( const Vec3& deltaScale )
     m_Scale = deltaScale;
 }
 
+void Entity::SetPhysicsFlagsFromType()
+{
+    const EntityPhysicsFlags& flags = ENTITY_PHYSICS_FLAGS[ m_EntityType ];
+    m_OverlapsTiles = flags.overlapsTiles;
+    m_IsPushedByWalls = flags.isPushedByWalls;
+    m_OverlapsEntities = flags.overlapsEntities;
+    m_IsFixed = flags.isFixed;
+    m_IsPushedByEntities = flags.isPushedByEntities;
+    m_DoesPushEntities = flags.doesPushEntities;
+    m_IsHitByBullets = flags.isHitByBullets;
+    m_UsesSweptCollision = flags.usesSweptCollision;
+}
+
 void Entity::SetUniformScale( float newScale )
 {
     m_Scale = Vec3( newScale, newScale, newScale );
@@ -406,44 +393,50 @@ void Entity::AddUniformScale( float deltaScale )
 //-------------------------------------------------------------------------------
 void Entity::SetAngleDegrees( float newRotationDegrees )
 {
-    m_AngleDegrees = newRotationDegrees;
+    m_Kinematics->SetAngleDegrees( m_KinematicsSlot, newRotationDegrees );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::AddAngleDegrees( float deltaDegrees )
 {
-    m_AngleDegrees += deltaDegrees;
+    m_Kinematics->SetAngleDegrees( m_KinematicsSlot, GetAngleDegrees() + deltaDegrees );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::SetAngularVelocity( float newAngularVelocity )
 {
-    m_AngularVelocity = newAngularVelocity;
+    m_Kinematics->SetAngularVelocity( m_KinematicsSlot, newAngularVelocity );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::AddAngularVelocity( float deltaAngularVelocity )
 {
-    m_AngularVelocity += deltaAngularVelocity;
+    m_Kinematics->SetAngularVelocity( m_KinematicsSlot, GetAngularVelocity() + deltaAngularVelocity );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::SetAngularAcceleration( float newAngularAcceleration )
 {
-    m_AngularAcceleration = newAngularAcceleration;
+    m_Kinematics->SetAngularAcceleration( m_KinematicsSlot, newAngularAcceleration );
 }
 
 //-------------------------------------------------------------------------------
 void Entity::AddAngularAcceleration( float deltaAngularAcceleration )
 {
-    m_AngularAcceleration += deltaAngularAcceleration;
+    m_Kinematics->SetAngularAcceleration( m_KinematicsSlot, GetAngularAcceleration() + deltaAngularAcceleration );
 }
 
 
 
 void Entity::SetVelocityModifier( float velocityModifier )
 {
-    m_VelocityModifier = velocityModifier;
+    m_Kinematics->SetVelocityModifier( m_KinematicsSlot, velocityModifier );
+}
+
+// Applied to the velocity at the end of Map's integration pass
+void Entity::SetMaxSpeed( float maxSpeed )
+{
+    m_Kinematics->SetMaxSpeed( m_KinematicsSlot, maxSpeed );
 }
 
 void Entity::SetHealth( int newHealth )
@@ -473,3 +466,49 @@ void Entity::SetDead( bool newDead )
 {
     m_IsDead = newDead;
 }
+
+void Entity::SetHandle( const EntityHandle& handle )
+{
+    m_Handle = handle;
+}
+
+//-------------------------------------------------------------------------------
+// Carries the entity's kinematic state over to the new map's arrays
+void Entity::MoveToMap( Map* newMap )
+{
+    EntityKinematics& newKinematics = newMap->GetEntityKinematics();
+    int newSlot = newKinematics.AddSlot( GetPosition() );
+    newKinematics.SetPreviousPosition( newSlot, GetPreviousPosition() );
+    newKinematics.SetVelocity( newSlot, GetVelocity() );
+    newKinematics.SetAcceleration( newSlot, GetAcceleration() );
+    newKinematics.SetAngleDegrees( newSlot, GetAngleDegrees() );
+    newKinematics.SetAngularVelocity( newSlot, GetAngularVelocity() );
+    newKinematics.SetAngularAcceleration( newSlot, GetAngularAcceleration() );
+    newKinematics.SetVelocityModifier( newSlot, GetVelocityModifier() );
+    newKinematics.SetMaxSpeed( newSlot, GetMaxSpeed() );
+
+    ReleaseKinematics();
+    m_CurrentMap = newMap;
+    m_Kinematics = &newKinematics;
+    m_KinematicsSlot = newSlot;
+}
+
+// Called when the entity leaves its map, its state can't be read after this
+void Entity::ReleaseKinematics()
+{
+    if( m_Kinematics == nullptr ) { return; }
+
+    m_Kinematics->RemoveSlot( m_KinematicsSlot );
+    m_Kinematics = nullptr;
+    m_KinematicsSlot = -1;
+}
+
+void Entity::ReuseAt( const Vec3& position )
+{
+    m_Kinematics = &m_CurrentMap->GetEntityKinematics();
+    m_KinematicsSlot = m_Kinematics->AddSlot( position );
+
+    m_Age = 0.f;
+    m_IsDead = false;
+    m_IsGarbage = false;
+}
@@ -1,23 +1,41 @@
 #pragma once
 
+#include <vector>
+
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/Rgba8.hpp"
-#include "Engine/Core/STL/RapidReplaceVector.hpp"
 #include "Engine/Core/Math/Primatives/Disc.hpp"
 #include "Engine/Core/Math/Primatives/Vec2.hpp"
 #include "Engine/Core/Math/Primatives/Vec3.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/Entity/EntityHandle.hpp"
 
 class Game;
 class Map;
 class Texture;
 class SpriteDefinition;
 class Entity;
+class EntityKinematics;
 
-typedef RapidReplaceVector<Entity*> EntityList;
 typedef int EntityListIndex;
 
+// Entities of one type with no empty slots, so loops over a list never test
+// for null. Removing an entity moves the last one into its slot, refer to
+// entities across frames by EntityHandle rather than by slot.
+class EntityList
+{
+public:
+    std::vector<Entity*> data;
+
+    void Add( Entity* entity )  { data.push_back( entity ); }
+    void RemoveAt( int index )
+    {
+        data[ index ] = data.back();
+        data.pop_back();
+    }
+};
+
 enum EntityType
 {
     ENTITY_INVALID = -1,
@@ -55,6 +73,8 @@ enum class EntityOverlapType
     PUSH_NO_PUSH,
     PUSH_FIXED,
     FIXED_NO_PUSH,
+
+    NUM_ENTITY_OVERLAP_TYPES
 };
 
 enum Faction
@@ -97,6 +117,7 @@ public:
     // Entity Vector3 queries
     const Vec3 GetPosition() const;
     const Vec3 GetVelocity() const;
+    const Vec3 GetPreviousPosition() const;
     const Vec3 GetAcceleration() const;
     const Vec3 GetForwardVector() const;
     const Vec3 GetScale() const;
@@ -112,9 +133,11 @@ public:
     EntityType GetEntityType() const;
     Faction GetEntityFaction() const;
     float GetVelocityModifier() const;
+    float GetMaxSpeed() const;
     float GetAge() const;
     int GetHealth() const;
     bool IsDead() const;
+    const EntityHandle& GetHandle() const;
 
     //-------------------------------------------------------------------------
     // Entity Renderer queries
@@ -124,12 +147,16 @@ public:
     //-------------------------------------------------------------------------
     // Entity Physics queries
     const Disc GetEntityPhysicsDisc() const;
+    float GetPhysicsRadius() const;
+    float GetCosmeticRadius() const;
     const Vec2 GetBoundBoxUnits() const;
     bool IsFixed() const;
     bool IsPushedByWalls() const;
     bool IsPushedByEntities() const;
     bool DoesPushEntities() const;
     bool IsHitByBullets() const;
+    bool OverlapsEntities() const;
+    bool UsesSweptCollision() const;
     const Vec3 GetPhysicsDiscNormalAt( const Vec3& hitPosition );
 
     //-------------------------------------------------------------------------
@@ -164,23 +191,32 @@ public:
     //-------------------------------------------------------------------------
     // Entity Members modifiers
     void SetVelocityModifier( float velocityModifier );
+    void SetMaxSpeed( float maxSpeed );
     void SetHealth( int newHealth );
     void DamageEntity( int damage );
     void SetDead( bool newDead );
+    // Set by the map the entity is added to
+    void SetHandle( const EntityHandle& handle );
+
+    //-------------------------------------------------------------------------
+    // Kinematics storage, owned by the entity's map
+    void MoveToMap( Map* newMap );
+    void ReleaseKinematics();
 
 protected:
+    // Copies the type's row of ENTITY_PHYSICS_FLAGS, call once m_EntityType is set
+    void SetPhysicsFlagsFromType();
+    // Brings a pooled entity back to life at the position on its map, callers
+    // reset anything else their type changes over a lifetime
+    void ReuseAt( const Vec3& position );
+
     //-------------------------------------------------------------------------
-    // Positional Members and Vec3 Quantities
-    Vec3 m_Position = Vec3::ZERO;               // Position of the Entity units
-    Vec3 m_Velocity = Vec3::ZERO;               // Velocity of the Entity u/s
-    Vec3 m_Acceleration = Vec3::ZERO;           // Acceleration of the Entity u/s/s
+    // Kinematic Members
+    // Position, velocity, acceleration, angle and their rates live in the
+    // map's EntityKinematics arrays, reached through this slot
+    EntityKinematics* m_Kinematics = nullptr;
+    int m_KinematicsSlot = -1;
     Vec3 m_Scale = Vec3::ONE;                   // Uniform scale
-    
-    //-------------------------------------------------------------------------
-    // Angular Members
-    float m_AngleDegrees = 0.f;                 // Angular Orientation of the Entity ( 0 is East )
-    float m_AngularVelocity = 0.f;              // Angular Velocity of the Entity deg/s
-    float m_AngularAcceleration = 0.f;          // Angular Acceleration of the Entity deg/s/s
 
     //-------------------------------------------------------------------------
     // Entity Members
@@ -188,10 +224,10 @@ protected:
     Map* m_CurrentMap = nullptr;
     EntityType m_EntityType = ENTITY_INVALID;   // Entity type
     Faction m_EntityFaction = FACTION_NEUTRAL;
-    float m_VelocityModifier = 1.f;
     float m_Age = 0.f;                          // Age of the entity from spawn time
     int m_Health = 1;                           // Health of the Entity
     bool m_IsDead = false;                      // Is the Entity Dead
+    EntityHandle m_Handle;                      // Handle on the current map
 
     //-------------------------------------------------------------------------
     // Renderer Members
@@ -215,6 +251,7 @@ protected:
     bool m_IsPushedByEntities = false;
     bool m_DoesPushEntities = false;
     bool m_IsHitByBullets = false;
+    bool m_UsesSweptCollision = false;
 
     //-------------------------------------------------------------------------
     // Cleanup Members
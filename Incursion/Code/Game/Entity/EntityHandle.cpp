@@ -0,0 +1,66 @@
+#include "EntityHandle.hpp"
+
+//-----------------------------------------------------------------------------
+EntityHandle EntityHandleTable::Add( Entity* entity )
+{
+    uint32_t index = 0;
+    if( !m_FreeSlots.empty() )
+    {
+        index = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_Slots.size());
+        m_Slots.emplace_back();
+    }
+
+    Slot& slot = m_Slots[ index ];
+    slot.entity = entity;
+
+    EntityHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    return handle;
+}
+
+void EntityHandleTable::Remove( const EntityHandle& handle )
+{
+    if( Get( handle ) == nullptr ) { return; }
+
+    Slot& slot = m_Slots[ handle.index ];
+    slot.entity = nullptr;
+
+    // Skips 0 when it wraps so the default handle stays unset
+    ++slot.generation;
+    if( slot.generation == 0 ) { slot.generation = 1; }
+
+    m_FreeSlots.push_back( handle.index );
+}
+
+// Every outstanding handle goes stale
+void EntityHandleTable::Clear()
+{
+    m_FreeSlots.clear();
+    for( int slotIndex = static_cast<int>(m_Slots.size()) - 1; slotIndex >= 0; --slotIndex )
+    {
+        Slot& slot = m_Slots[ slotIndex ];
+        if( slot.entity != nullptr )
+        {
+            slot.entity = nullptr;
+            ++slot.generation;
+            if( slot.generation == 0 ) { slot.generation = 1; }
+        }
+        m_FreeSlots.push_back( static_cast<uint32_t>(slotIndex) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+Entity* EntityHandleTable::Get( const EntityHandle& handle ) const
+{
+    if( handle.index >= m_Slots.size() ) { return nullptr; }
+
+    const Slot& slot = m_Slots[ handle.index ];
+    if( slot.generation != handle.generation ) { return nullptr; }
+    return slot.entity;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Entity;
+
+//-----------------------------------------------------------------------------
+// Refers to an entity without keeping it alive. Each time a slot is freed its
+// generation changes, so a handle to a removed entity resolves to nullptr
+// rather than to whatever took the slot over. Generation 0 is never handed
+// out, so a default handle refers to nothing.
+struct EntityHandle
+{
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool IsSet() const                                  { return generation != 0; }
+    bool operator==( const EntityHandle& other ) const  { return index == other.index && generation == other.generation; }
+    bool operator!=( const EntityHandle& other ) const  { return !(*this == other); }
+};
+
+//-----------------------------------------------------------------------------
+// Handles for the entities on a map. Entities can move around in their lists
+// without their handles changing.
+class EntityHandleTable
+{
+public:
+    EntityHandle Add( Entity* entity );
+    // Does nothing if the handle was already removed
+    void Remove( const EntityHandle& handle );
+    void Clear();
+
+    Entity* Get( const EntityHandle& handle ) const;
+    int GetNumHandles() const   { return static_cast<int>(m_Slots.size() - m_FreeSlots.size()); }
+
+private:
+    struct Slot
+    {
+        Entity* entity = nullptr;
+        uint32_t generation = 1;
+    };
+    std::vector<Slot> m_Slots;
+    std::vector<uint32_t> m_FreeSlots;
+};
\ No newline at end of file
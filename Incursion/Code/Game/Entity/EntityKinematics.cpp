@@ -0,0 +1,177 @@
+#include "EntityKinematics.hpp"
+
+#include <emmintrin.h>
+#include <limits>
+
+constexpr int KINEMATICS_SIMD_WIDTH = 4;
+constexpr float NO_MAX_SPEED = std::numeric_limits<float>::infinity();
+
+//-----------------------------------------------------------------------------
+int EntityKinematics::AddSlot( const Vec3& position )
+{
+    int slot = 0;
+    if( !m_FreeSlots.empty() )
+    {
+        slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    }
+    else
+    {
+        slot = m_NumSlots++;
+        if( m_NumSlots > static_cast<int>(m_StepSeconds.size()) )
+        {
+            int numPaddedSlots = static_cast<int>(m_StepSeconds.size()) * 2;
+            if( numPaddedSlots < KINEMATICS_SIMD_WIDTH ) { numPaddedSlots = KINEMATICS_SIMD_WIDTH; }
+            ResizeArrays( numPaddedSlots );
+        }
+    }
+
+    ResetSlot( slot );
+    SetPosition( slot, position );
+    SetPreviousPosition( slot, position );
+    return slot;
+}
+
+void EntityKinematics::RemoveSlot( int slot )
+{
+    ResetSlot( slot );
+    m_FreeSlots.push_back( slot );
+}
+
+void EntityKinematics::Clear()
+{
+    m_NumSlots = 0;
+    m_FreeSlots.clear();
+    ResizeArrays( 0 );
+}
+
+//-----------------------------------------------------------------------------
+void EntityKinematics::SetPosition( int slot, const Vec3& position )
+{
+    m_PositionX[ slot ] = position.x;
+    m_PositionY[ slot ] = position.y;
+    m_PositionZ[ slot ] = position.z;
+}
+
+void EntityKinematics::SetPreviousPosition( int slot, const Vec3& position )
+{
+    m_PreviousX[ slot ] = position.x;
+    m_PreviousY[ slot ] = position.y;
+    m_PreviousZ[ slot ] = position.z;
+}
+
+void EntityKinematics::SetVelocity( int slot, const Vec3& velocity )
+{
+    m_VelocityX[ slot ] = velocity.x;
+    m_VelocityY[ slot ] = velocity.y;
+    m_VelocityZ[ slot ] = velocity.z;
+}
+
+void EntityKinematics::SetAcceleration( int slot, const Vec3& acceleration )
+{
+    m_AccelerationX[ slot ] = acceleration.x;
+    m_AccelerationY[ slot ] = acceleration.y;
+    m_AccelerationZ[ slot ] = acceleration.z;
+}
+
+//-----------------------------------------------------------------------------
+// Lanes that stepped get the same update Entity::Update used to do:
+//   velocity *= modifier, previous = position, position += velocity * dt,
+//   velocity += acceleration * dt, angle += angular velocity * dt,
+//   angular velocity += angular acceleration * dt, modifier = 1
+// then clamps the new velocity to the slot's max speed, where the player
+// used to clamp after Entity::Update. Lanes that didn't step are written
+// back unchanged.
+void EntityKinematics::Integrate()
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.f );
+
+    for( int slot = 0; slot < m_NumSlots; slot += KINEMATICS_SIMD_WIDTH )
+    {
+        __m128 step = _mm_loadu_ps( &m_StepSeconds[ slot ] );
+        __m128 isStepping = _mm_cmpgt_ps( step, zero );
+        if( _mm_movemask_ps( isStepping ) == 0 ) { continue; }
+
+        __m128 modifier = _mm_loadu_ps( &m_VelocityModifier[ slot ] );
+        __m128 appliedModifier = _mm_or_ps( _mm_and_ps( isStepping, modifier ), _mm_andnot_ps( isStepping, one ) );
+
+        float* positions[ 3 ] = { &m_PositionX[ slot ], &m_PositionY[ slot ], &m_PositionZ[ slot ] };
+        float* previous[ 3 ] = { &m_PreviousX[ slot ], &m_PreviousY[ slot ], &m_PreviousZ[ slot ] };
+        float* velocities[ 3 ] = { &m_VelocityX[ slot ], &m_VelocityY[ slot ], &m_VelocityZ[ slot ] };
+        const float* accelerations[ 3 ] = { &m_AccelerationX[ slot ], &m_AccelerationY[ slot ], &m_AccelerationZ[ slot ] };
+        __m128 newVelocities[ 3 ];
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            __m128 position = _mm_loadu_ps( positions[ axis ] );
+            __m128 velocity = _mm_mul_ps( _mm_loadu_ps( velocities[ axis ] ), appliedModifier );
+            __m128 previousPosition = _mm_loadu_ps( previous[ axis ] );
+            previousPosition = _mm_or_ps( _mm_and_ps( isStepping, position ), _mm_andnot_ps( isStepping, previousPosition ) );
+
+            position = _mm_add_ps( position, _mm_mul_ps( velocity, step ) );
+            newVelocities[ axis ] = _mm_add_ps( velocity, _mm_mul_ps( _mm_loadu_ps( accelerations[ axis ] ), step ) );
+
+            _mm_storeu_ps( positions[ axis ], position );
+            _mm_storeu_ps( previous[ axis ], previousPosition );
+        }
+
+        __m128 maxSpeed = _mm_loadu_ps( &m_MaxSpeed[ slot ] );
+        __m128 speedSquared = _mm_add_ps( _mm_add_ps( _mm_mul_ps( newVelocities[ 0 ], newVelocities[ 0 ] ),
+                                                      _mm_mul_ps( newVelocities[ 1 ], newVelocities[ 1 ] ) ),
+                                          _mm_mul_ps( newVelocities[ 2 ], newVelocities[ 2 ] ) );
+        __m128 isTooFast = _mm_and_ps( isStepping, _mm_cmpgt_ps( speedSquared, _mm_mul_ps( maxSpeed, maxSpeed ) ) );
+        __m128 speedScale = one;
+        if( _mm_movemask_ps( isTooFast ) != 0 )
+        {
+            __m128 clampScale = _mm_div_ps( maxSpeed, _mm_sqrt_ps( speedSquared ) );
+            speedScale = _mm_or_ps( _mm_and_ps( isTooFast, clampScale ), _mm_andnot_ps( isTooFast, one ) );
+        }
+        for( int axis = 0; axis < 3; ++axis )
+        {
+            _mm_storeu_ps( velocities[ axis ], _mm_mul_ps( newVelocities[ axis ], speedScale ) );
+        }
+
+        __m128 angle = _mm_loadu_ps( &m_AngleDegrees[ slot ] );
+        __m128 angularVelocity = _mm_loadu_ps( &m_AngularVelocity[ slot ] );
+        angle = _mm_add_ps( angle, _mm_mul_ps( angularVelocity, step ) );
+        angularVelocity = _mm_add_ps( angularVelocity, _mm_mul_ps( _mm_loadu_ps( &m_AngularAcceleration[ slot ] ), step ) );
+        _mm_storeu_ps( &m_AngleDegrees[ slot ], angle );
+        _mm_storeu_ps( &m_AngularVelocity[ slot ], angularVelocity );
+
+        modifier = _mm_or_ps( _mm_and_ps( isStepping, one ), _mm_andnot_ps( isStepping, modifier ) );
+        _mm_storeu_ps( &m_VelocityModifier[ slot ], modifier );
+        _mm_storeu_ps( &m_StepSeconds[ slot ], zero );
+    }
+}
+
+//-----------------------------------------------------------------------------
+void EntityKinematics::ResetSlot( int slot )
+{
+    SetPosition( slot, Vec3::ZERO );
+    SetPreviousPosition( slot, Vec3::ZERO );
+    SetVelocity( slot, Vec3::ZERO );
+    SetAcceleration( slot, Vec3::ZERO );
+    m_AngleDegrees[ slot ] = 0.f;
+    m_AngularVelocity[ slot ] = 0.f;
+    m_AngularAcceleration[ slot ] = 0.f;
+    m_VelocityModifier[ slot ] = 1.f;
+    m_MaxSpeed[ slot ] = NO_MAX_SPEED;
+    m_StepSeconds[ slot ] = 0.f;
+}
+
+// Padding slots start at rest with no step, so they integrate to themselves
+void EntityKinematics::ResizeArrays( int numPaddedSlots )
+{
+    std::vector<float>* zeroedArrays[] = { &m_PositionX, &m_PositionY, &m_PositionZ,
+                                           &m_PreviousX, &m_PreviousY, &m_PreviousZ,
+                                           &m_VelocityX, &m_VelocityY, &m_VelocityZ,
+                                           &m_AccelerationX, &m_AccelerationY, &m_AccelerationZ,
+                                           &m_AngleDegrees, &m_AngularVelocity, &m_AngularAcceleration,
+                                           &m_StepSeconds };
+    for( std::vector<float>* zeroedArray : zeroedArrays )
+    {
+        zeroedArray->resize( numPaddedSlots, 0.f );
+    }
+    m_VelocityModifier.resize( numPaddedSlots, 1.f );
+    m_MaxSpeed.resize( numPaddedSlots, NO_MAX_SPEED );
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/Vec3.hpp"
+
+//-----------------------------------------------------------------------------
+// Kinematic state of every entity on a map, one array per component so the
+// whole map integrates in a single SIMD pass. Entities keep a slot and read
+// and write their state through it. Slots don't move, freed slots are reused
+// by the next entity added.
+//
+// An entity only moves in a frame if it asked to with Step, which mirrors
+// entities that skip Entity::Update while dead.
+class EntityKinematics
+{
+public:
+    int AddSlot( const Vec3& position );
+    void RemoveSlot( int slot );
+    void Clear();
+
+    // Integrates every slot that was stepped since the last call
+    void Integrate();
+
+    int GetNumSlots() const                                 { return m_NumSlots; }
+    int GetNumFreeSlots() const                             { return static_cast<int>(m_FreeSlots.size()); }
+
+    void Step( int slot, float deltaSeconds )               { m_StepSeconds[ slot ] = deltaSeconds; }
+
+    Vec3 GetPosition( int slot ) const                      { return Vec3( m_PositionX[ slot ], m_PositionY[ slot ], m_PositionZ[ slot ] ); }
+    Vec3 GetPreviousPosition( int slot ) const              { return Vec3( m_PreviousX[ slot ], m_PreviousY[ slot ], m_PreviousZ[ slot ] ); }
+    Vec3 GetVelocity( int slot ) const                      { return Vec3( m_VelocityX[ slot ], m_VelocityY[ slot ], m_VelocityZ[ slot ] ); }
+    Vec3 GetAcceleration( int slot ) const                  { return Vec3( m_AccelerationX[ slot ], m_AccelerationY[ slot ], m_AccelerationZ[ slot ] ); }
+    float GetAngleDegrees( int slot ) const                 { return m_AngleDegrees[ slot ]; }
+    float GetAngularVelocity( int slot ) const              { return m_AngularVelocity[ slot ]; }
+    float GetAngularAcceleration( int slot ) const          { return m_AngularAcceleration[ slot ]; }
+    float GetVelocityModifier( int slot ) const             { return m_VelocityModifier[ slot ]; }
+    float GetMaxSpeed( int slot ) const                     { return m_MaxSpeed[ slot ]; }
+
+    void SetPosition( int slot, const Vec3& position );
+    void SetPreviousPosition( int slot, const Vec3& position );
+    void SetVelocity( int slot, const Vec3& velocity );
+    void SetAcceleration( int slot, const Vec3& acceleration );
+    void SetAngleDegrees( int slot, float angleDegrees )                { m_AngleDegrees[ slot ] = angleDegrees; }
+    void SetAngularVelocity( int slot, float angularVelocity )          { m_AngularVelocity[ slot ] = angularVelocity; }
+    void SetAngularAcceleration( int slot, float angularAcceleration )  { m_AngularAcceleration[ slot ] = angularAcceleration; }
+    void SetVelocityModifier( int slot, float velocityModifier )        { m_VelocityModifier[ slot ] = velocityModifier; }
+    void SetMaxSpeed( int slot, float maxSpeed )                        { m_MaxSpeed[ slot ] = maxSpeed; }
+
+private:
+    int m_NumSlots = 0;
+    std::vector<int> m_FreeSlots;
+
+    // Sized to a multiple of the SIMD width, padding slots never step
+    std::vector<float> m_PositionX;
+    std::vector<float> m_PositionY;
+    std::vector<float> m_PositionZ;
+    std::vector<float> m_PreviousX;
+    std::vector<float> m_PreviousY;
+    std::vector<float> m_PreviousZ;
+    std::vector<float> m_VelocityX;
+    std::vector<float> m_VelocityY;
+    std::vector<float> m_VelocityZ;
+    std::vector<float> m_AccelerationX;
+    std::vector<float> m_AccelerationY;
+    std::vector<float> m_AccelerationZ;
+    std::vector<float> m_AngleDegrees;
+    std::vector<float> m_AngularVelocity;
+    std::vector<float> m_AngularAcceleration;
+    std::vector<float> m_VelocityModifier;
+    std::vector<float> m_MaxSpeed;          // Infinite for slots with no limit
+    std::vector<float> m_StepSeconds;       // 0 for slots that don't move this frame
+
+    void ResetSlot( int slot );
+    void ResizeArrays( int numPaddedSlots );
+};
\ No newline at end of file
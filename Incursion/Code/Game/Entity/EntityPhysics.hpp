@@ -0,0 +1,211 @@
+#pragma once
+
+#include "Game/Entity/Entity.hpp"
+
+//-----------------------------------------------------------------------------
+// Physics flags shared by every entity of a type. Entity constructors copy
+// these in, and the collision matrix below is generated from them.
+struct EntityPhysicsFlags
+{
+    bool overlapsTiles;
+    bool isPushedByWalls;
+    bool overlapsEntities;
+    bool isFixed;
+    bool isPushedByEntities;
+    bool doesPushEntities;
+    bool isHitByBullets;
+    bool usesSweptCollision;    // Fast movers test their whole path for the frame
+};
+
+//                                       tiles  walls  ents   fixed  pushed pushes bullets swept
+constexpr EntityPhysicsFlags PHYSICS_NONE   { false, false, false, false, false, false, false,  false };
+constexpr EntityPhysicsFlags PHYSICS_TANK   { true,  true,  true,  false, true,  true,  true,   false };
+constexpr EntityPhysicsFlags PHYSICS_TURRET { false, true,  true,  true,  false, true,  true,   false };
+constexpr EntityPhysicsFlags PHYSICS_BULLET { true,  false, true,  false, false, false, false,  true  };
+
+constexpr EntityPhysicsFlags ENTITY_PHYSICS_FLAGS[ NUM_ENTITY_TYPES ] = {
+    PHYSICS_TURRET,     // ENTITY_ALLIED_TURRET
+    PHYSICS_TURRET,     // ENTITY_ENEMY_TURRET
+    PHYSICS_TANK,       // ENTITY_ALLIED_TANK
+    PHYSICS_TANK,       // ENTITY_ENEMY_TANK
+    PHYSICS_TANK,       // ENTITY_PLAYER
+    PHYSICS_TANK,       // ENTITY_BOLDER
+    PHYSICS_BULLET,     // ENTITY_BULLET_ALLIED
+    PHYSICS_BULLET,     // ENTITY_BULLET_ENEMY
+    PHYSICS_NONE,       // ENTITY_EXPLOSION
+    PHYSICS_NONE,       // ENTITY_EXPLOSION_BULLET
+    PHYSICS_NONE,       // ENTITY_EXPLOSION_NPC
+    PHYSICS_NONE,       // ENTITY_EXPLOSION_PLAYER
+    PHYSICS_NONE,       // ENTITY_DEBRIS
+};
+
+//-----------------------------------------------------------------------------
+constexpr bool IsBulletEntityType( int type )
+{
+    return type == ENTITY_BULLET_ALLIED || type == ENTITY_BULLET_ENEMY;
+}
+
+// Bullets skip each other and their own side's tanks and turrets
+constexpr bool CanEntityTypesInteract( int type1, int type2 )
+{
+    if( IsBulletEntityType( type1 ) && IsBulletEntityType( type2 ) && type1 != type2 ) { return false; }
+    if( type1 == ENTITY_BULLET_ALLIED && (type2 == ENTITY_ALLIED_TANK || type2 == ENTITY_ALLIED_TURRET) ) { return false; }
+    if( type2 == ENTITY_BULLET_ALLIED && (type1 == ENTITY_ALLIED_TANK || type1 == ENTITY_ALLIED_TURRET) ) { return false; }
+    if( type1 == ENTITY_BULLET_ENEMY && (type2 == ENTITY_ENEMY_TANK || type2 == ENTITY_ENEMY_TURRET) ) { return false; }
+    if( type2 == ENTITY_BULLET_ENEMY && (type1 == ENTITY_ENEMY_TANK || type1 == ENTITY_ENEMY_TURRET) ) { return false; }
+    return true;
+}
+
+constexpr EntityOverlapType GetEntityTypesOverlapType( int type1, int type2 )
+{
+    if( !CanEntityTypesInteract( type1, type2 ) ) { return EntityOverlapType::NONE; }
+
+    const EntityPhysicsFlags& flags1 = ENTITY_PHYSICS_FLAGS[ type1 ];
+    const EntityPhysicsFlags& flags2 = ENTITY_PHYSICS_FLAGS[ type2 ];
+    if( !flags1.overlapsEntities || !flags2.overlapsEntities ) { return EntityOverlapType::NONE; }
+    if( !flags1.isHitByBullets && IsBulletEntityType( type2 ) ) { return EntityOverlapType::NONE; }
+    if( !flags2.isHitByBullets && IsBulletEntityType( type1 ) ) { return EntityOverlapType::NONE; }
+
+    if( flags1.doesPushEntities && flags1.isPushedByEntities &&
+        flags2.doesPushEntities && flags2.isPushedByEntities )
+    {
+        return EntityOverlapType::PUSH_PUSH;
+    }
+    if( (flags1.doesPushEntities && flags2.isPushedByEntities && !flags1.isFixed) ||
+        (flags2.doesPushEntities && flags1.isPushedByEntities && !flags2.isFixed) )
+    {
+        return EntityOverlapType::PUSH_NO_PUSH;
+    }
+    if( (flags1.doesPushEntities && flags2.isFixed && !flags1.isFixed) ||
+        (flags2.doesPushEntities && flags1.isFixed && !flags2.isFixed) )
+    {
+        return EntityOverlapType::PUSH_FIXED;
+    }
+    return EntityOverlapType::OVERLAP_ONLY;
+}
+
+//-----------------------------------------------------------------------------
+struct EntityCollisionMatrix
+{
+    EntityOverlapType overlapTypes[ NUM_ENTITY_TYPES ][ NUM_ENTITY_TYPES ];
+};
+
+constexpr EntityCollisionMatrix MakeEntityCollisionMatrix()
+{
+    EntityCollisionMatrix matrix = {};
+    for( int type1 = 0; type1 < NUM_ENTITY_TYPES; ++type1 )
+    {
+        for( int type2 = 0; type2 < NUM_ENTITY_TYPES; ++type2 )
+        {
+            matrix.overlapTypes[ type1 ][ type2 ] = GetEntityTypesOverlapType( type1, type2 );
+        }
+    }
+    return matrix;
+}
+
+constexpr EntityCollisionMatrix ENTITY_COLLISION_MATRIX = MakeEntityCollisionMatrix();
+
+constexpr bool IsEntityCollisionMatrixSymmetric()
+{
+    for( int type1 = 0; type1 < NUM_ENTITY_TYPES; ++type1 )
+    {
+        for( int type2 = 0; type2 < NUM_ENTITY_TYPES; ++type2 )
+        {
+            if( ENTITY_COLLISION_MATRIX.overlapTypes[ type1 ][ type2 ] != ENTITY_COLLISION_MATRIX.overlapTypes[ type2 ][ type1 ] )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// The per pair rules the matrix replaced, written against the flags each
+// constructor used to set by hand. Kept separate from ENTITY_PHYSICS_FLAGS
+// so the check below doesn't just compare the matrix with itself.
+constexpr bool OldRulesIsTankLike( int type )
+{
+    return type == ENTITY_ALLIED_TANK || type == ENTITY_ENEMY_TANK || type == ENTITY_PLAYER || type == ENTITY_BOLDER;
+}
+
+constexpr bool OldRulesIsTurret( int type )
+{
+    return type == ENTITY_ALLIED_TURRET || type == ENTITY_ENEMY_TURRET;
+}
+
+constexpr bool OldRulesOverlapsEntities( int type )     { return OldRulesIsTankLike( type ) || OldRulesIsTurret( type ) || IsBulletEntityType( type ); }
+constexpr bool OldRulesIsFixed( int type )              { return OldRulesIsTurret( type ); }
+constexpr bool OldRulesIsPushedByEntities( int type )   { return OldRulesIsTankLike( type ); }
+constexpr bool OldRulesDoesPushEntities( int type )     { return OldRulesIsTankLike( type ) || OldRulesIsTurret( type ); }
+constexpr bool OldRulesIsHitByBullets( int type )       { return OldRulesIsTankLike( type ) || OldRulesIsTurret( type ); }
+
+constexpr bool OldRulesDoEntityListsOverlap( int l1, int l2 )
+{
+    // Bullets do not overlap
+    if( (l1 == ENTITY_BULLET_ALLIED && l2 == ENTITY_BULLET_ENEMY) ||
+        (l2 == ENTITY_BULLET_ALLIED && l1 == ENTITY_BULLET_ENEMY) )
+    {
+        return false;
+    }
+
+    // Allied bullets do not overlap allied tanks or turrets
+    if( (l1 == ENTITY_BULLET_ALLIED && (l2 == ENTITY_ALLIED_TANK || l2 == ENTITY_ALLIED_TURRET)) ||
+        (l2 == ENTITY_BULLET_ALLIED && (l1 == ENTITY_ALLIED_TANK || l1 == ENTITY_ALLIED_TURRET)) )
+    {
+        return false;
+    }
+
+    // Enemy bullets do not overlap enemy tanks or turrets
+    if( (l1 == ENTITY_BULLET_ENEMY && (l2 == ENTITY_ENEMY_TANK || l2 == ENTITY_ENEMY_TURRET)) ||
+        (l2 == ENTITY_BULLET_ENEMY && (l1 == ENTITY_ENEMY_TANK || l1 == ENTITY_ENEMY_TURRET)) )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+constexpr EntityOverlapType GetOldRulesOverlapType( int type1, int type2 )
+{
+    if( !OldRulesDoEntityListsOverlap( type1, type2 ) ) { return EntityOverlapType::NONE; }
+    if( !OldRulesOverlapsEntities( type1 ) || !OldRulesOverlapsEntities( type2 ) ) { return EntityOverlapType::NONE; }
+    if( !OldRulesIsHitByBullets( type1 ) && IsBulletEntityType( type2 ) ) { return EntityOverlapType::NONE; }
+    if( !OldRulesIsHitByBullets( type2 ) && IsBulletEntityType( type1 ) ) { return EntityOverlapType::NONE; }
+
+    if( OldRulesDoesPushEntities( type1 ) && OldRulesIsPushedByEntities( type1 ) &&
+        OldRulesDoesPushEntities( type2 ) && OldRulesIsPushedByEntities( type2 ) )
+    {
+        return EntityOverlapType::PUSH_PUSH;
+    }
+    if( (OldRulesDoesPushEntities( type1 ) && OldRulesIsPushedByEntities( type2 ) && !OldRulesIsFixed( type1 )) ||
+        (OldRulesDoesPushEntities( type2 ) && OldRulesIsPushedByEntities( type1 ) && !OldRulesIsFixed( type2 )) )
+    {
+        return EntityOverlapType::PUSH_NO_PUSH;
+    }
+    if( (OldRulesDoesPushEntities( type1 ) && OldRulesIsFixed( type2 ) && !OldRulesIsFixed( type1 )) ||
+        (OldRulesDoesPushEntities( type2 ) && OldRulesIsFixed( type1 ) && !OldRulesIsFixed( type2 )) )
+    {
+        return EntityOverlapType::PUSH_FIXED;
+    }
+    return EntityOverlapType::OVERLAP_ONLY;
+}
+
+constexpr bool DoesEntityCollisionMatrixMatchOldRules()
+{
+    for( int type1 = 0; type1 < NUM_ENTITY_TYPES; ++type1 )
+    {
+        for( int type2 = 0; type2 < NUM_ENTITY_TYPES; ++type2 )
+        {
+            if( ENTITY_COLLISION_MATRIX.overlapTypes[ type1 ][ type2 ] != GetOldRulesOverlapType( type1, type2 ) )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+static_assert( IsEntityCollisionMatrixSymmetric(), "Entity collisions must not depend on pair order" );
+static_assert( DoesEntityCollisionMatrixMatchOldRules(), "Entity collision matrix must match the old per pair rules" );
\ No newline at end of file
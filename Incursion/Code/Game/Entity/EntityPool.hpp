@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Pool blocks start on their own cache line so neighbors never share one
+constexpr size_t ENTITY_POOL_BLOCK_ALIGNMENT = 64;
+
+//-----------------------------------------------------------------------------
+// Fixed number of entities of one type, constructed once into a single
+// allocation when the pool is warmed. Entities are handed out and taken back
+// without touching the heap, callers re-initialize what they acquire.
+template<typename ENTITY_TYPE>
+class EntityPool
+{
+public:
+    EntityPool() = default;
+    ~EntityPool();
+    EntityPool( const EntityPool& ) = delete;
+    EntityPool& operator=( const EntityPool& ) = delete;
+
+    // constructEntity( void* block ) placement news one entity into the block
+    template<typename CONSTRUCT_ENTITY>
+    void Prewarm( int capacity, CONSTRUCT_ENTITY constructEntity );
+
+    // nullptr once every entity is in use
+    ENTITY_TYPE* Acquire();
+    void Release( ENTITY_TYPE* entity );
+    bool Owns( const void* entity ) const;
+
+    int GetCapacity() const     { return m_Capacity; }
+    int GetNumFree() const      { return static_cast<int>(m_FreeEntities.size()); }
+
+private:
+    void* m_Storage = nullptr;
+    unsigned char* m_Blocks = nullptr;
+    size_t m_BlockSize = 0;
+    int m_Capacity = 0;
+    std::vector<ENTITY_TYPE*> m_FreeEntities;
+
+    ENTITY_TYPE* GetEntityInBlock( int blockIndex ) const;
+    void DestroyEntities();
+};
+
+//-----------------------------------------------------------------------------
+template<typename ENTITY_TYPE>
+EntityPool<ENTITY_TYPE>::~EntityPool()
+{
+    DestroyEntities();
+}
+
+template<typename ENTITY_TYPE>
+template<typename CONSTRUCT_ENTITY>
+void EntityPool<ENTITY_TYPE>::Prewarm( int capacity, CONSTRUCT_ENTITY constructEntity )
+{
+    DestroyEntities();
+
+    m_BlockSize = (sizeof( ENTITY_TYPE ) + ENTITY_POOL_BLOCK_ALIGNMENT - 1) & ~(ENTITY_POOL_BLOCK_ALIGNMENT - 1);
+    m_Storage = std::malloc( m_BlockSize * capacity + ENTITY_POOL_BLOCK_ALIGNMENT );
+    uintptr_t storageAddress = reinterpret_cast<uintptr_t>(m_Storage);
+    uintptr_t firstBlockAddress = (storageAddress + ENTITY_POOL_BLOCK_ALIGNMENT - 1) & ~static_cast<uintptr_t>(ENTITY_POOL_BLOCK_ALIGNMENT - 1);
+    m_Blocks = reinterpret_cast<unsigned char*>(firstBlockAddress);
+    m_Capacity = capacity;
+
+    // Handed out from the back, so the first block goes first
+    m_FreeEntities.reserve( capacity );
+    for( int blockIndex = 0; blockIndex < capacity; ++blockIndex )
+    {
+        constructEntity( m_Blocks + m_BlockSize * blockIndex );
+    }
+    for( int blockIndex = capacity - 1; blockIndex >= 0; --blockIndex )
+    {
+        m_FreeEntities.push_back( GetEntityInBlock( blockIndex ) );
+    }
+}
+
+template<typename ENTITY_TYPE>
+ENTITY_TYPE* EntityPool<ENTITY_TYPE>::Acquire()
+{
+    if( m_FreeEntities.empty() ) { return nullptr; }
+
+    ENTITY_TYPE* entity = m_FreeEntities.back();
+    m_FreeEntities.pop_back();
+    return entity;
+}
+
+template<typename ENTITY_TYPE>
+void EntityPool<ENTITY_TYPE>::Release( ENTITY_TYPE* entity )
+{
+    m_FreeEntities.push_back( entity );
+}
+
+template<typename ENTITY_TYPE>
+bool EntityPool<ENTITY_TYPE>::Owns( const void* entity ) const
+{
+    const unsigned char* address = static_cast<const unsigned char*>(entity);
+    return address >= m_Blocks && address < m_Blocks + m_BlockSize * m_Capacity;
+}
+
+//-----------------------------------------------------------------------------
+template<typename ENTITY_TYPE>
+ENTITY_TYPE* EntityPool<ENTITY_TYPE>::GetEntityInBlock( int blockIndex ) const
+{
+    return reinterpret_cast<ENTITY_TYPE*>(m_Blocks + m_BlockSize * blockIndex);
+}
+
+template<typename ENTITY_TYPE>
+void EntityPool<ENTITY_TYPE>::DestroyEntities()
+{
+    for( int blockIndex = 0; blockIndex < m_Capacity; ++blockIndex )
+    {
+        GetEntityInBlock( blockIndex )->~ENTITY_TYPE();
+    }
+
+    std::free( m_Storage );
+    m_Storage = nullptr;
+    m_Blocks = nullptr;
+    m_Capacity = 0;
+    m_FreeEntities.clear();
+}
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "Engine/Renderer/RenderContext.hpp"
 #include "Engine/Renderer/Sprite/SpriteAnimDefinition.hpp"
 
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 
 
@@ -25,30 +26,30 @@ Explosion::Explosion( Game* gameInstance,
 
     m_EntityType = ENTITY_EXPLOSION;
     m_EntityFaction = FACTION_NEUTRAL;
+
+    m_ExplosionAnimDef = m_GameInstance->GetExplosionAnimDefinition();
+    m_AddativeShader = m_GameInstance->GetExplosionShader();
 }
 
 void Explosion::Create()
 {
-    m_ExplosionAnimDef = new SpriteAnimDefinition( *g_Renderer->CreateOrGetSpriteSheetFromFile( "Data/Sprites/Explosion5x5.png",
-                                                                                                IntVec2( 5, 5 ) ),
-                                                   0,
-                                                   24,
-                                                   m_Duration,
-                                                   SpriteAnimPlaybackType::ONCE );
-
-    m_AngleDegrees = m_GameInstance->GetRng()->FloatLessThan( 360.f );
+    SetAngleDegrees( m_GameInstance->GetRng()->FloatLessThan( 360.f ) );
 
     m_ExplosionAnimStartTime = m_Age;
+}
 
-    m_AddativeShader = new Shader( g_Renderer->CreateOrGetShaderProgramFromFile( "DEFAULT" ) );
-    m_AddativeShader->depthCompare = DepthCompare::ALWAYS;
-    m_AddativeShader->writeDepth = false;
-    m_AddativeShader->blendMode = BlendMode::ADDITIVE;
+void Explosion::Reuse( const Vec3& position, float duration, const Vec3& scale )
+{
+    ReuseAt( position );
+
+    m_Duration = duration;
+    m_Scale = scale;
+    m_Sprite = nullptr;
 }
 
 void Explosion::Update( float deltaSeconds )
 {
-    float animTime = m_Age - m_ExplosionAnimStartTime;
+    float animTime = EXPLOSION_ANIM_SECONDS * (m_Age - m_ExplosionAnimStartTime) / m_Duration;
 
     if ( m_ExplosionAnimDef->IsComplete( animTime ) )
     {
@@ -71,9 +72,9 @@ void Explosion::Render() const
 
     AABB2 box = AABB2::MakeFromAspect( m_Sprite->GetAspectRatio() );
 
-    std::vector<VertexMaster> visual;
+    std::vector<VertexMaster>& visual = g_FrameArena->AllocateVertexList();
     AppendAABB2( visual, box, Rgba8::WHITE, minUv, maxUv );
-    TransformVertexArray( visual, static_cast<Vec2>(m_Position), m_AngleDegrees, static_cast<Vec2>(m_Scale) );
+    TransformVertexArray( visual, static_cast<Vec2>(GetPosition()), GetAngleDegrees(), static_cast<Vec2>(m_Scale) );
 
     g_Renderer->BindShader( m_AddativeShader );
     g_Renderer->BindTexture( &m_Sprite->GetTexture() );
@@ -87,10 +88,5 @@ void Explosion::Die()
 
 void Explosion::Destroy()
 {
-    delete m_ExplosionAnimDef;
-    m_ExplosionAnimDef = nullptr;
-
-    delete m_AddativeShader;
-    m_AddativeShader = nullptr;
 }
 
@@ -21,7 +21,11 @@ public:
     virtual void Die() override;
     virtual void Destroy() override;
 
+    // Restarts a pooled explosion
+    void Reuse( const Vec3& position, float duration, const Vec3& scale );
+
 private:
+    // Owned by the Game, shared by every explosion
     SpriteAnimDefinition* m_ExplosionAnimDef = nullptr;
     SpriteDefinition* m_SpriteDefinition = nullptr;
     float m_Duration = 1.f;
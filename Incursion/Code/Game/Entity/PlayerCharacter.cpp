@@ -9,6 +9,7 @@
 #include "Engine/Renderer/Fonts/BitmapFont.hpp"
 
 #include "Game/GameCommon.hpp"
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 #include "Game/AssetManagers/TextureManager.hpp"
 #include "Game/AssetManagers/AudioManager.hpp"
@@ -31,13 +32,8 @@ PlayerCharacter::PlayerCharacter( Game* gameInstance,
     m_EntityType = ENTITY_PLAYER;
     m_EntityFaction = FACTION_PLAYER;
 
-    m_OverlapsTiles = true;
-    m_IsPushedByWalls = true;
-    m_OverlapsEntities = true;
-    m_IsFixed = false;
-    m_IsPushedByEntities = true;
-    m_DoesPushEntities = true;
-    m_IsHitByBullets = true;
+    SetPhysicsFlagsFromType();
+    SetMaxSpeed( TANK_MAX_VELOCITY );
 
     m_DamageSoundInitiallized = true;
     m_DamageSound = AUDIO_PLAYER_HIT;
@@ -55,17 +51,15 @@ void PlayerCharacter::Update( float deltaSeconds )
     if ( m_IsDead || m_IsGarbage ) { return; }
 
 
-    m_AngleDegrees = GetTurnedTowards( m_AngleDegrees,
+    SetAngleDegrees( GetTurnedTowards( GetAngleDegrees(),
                                        m_TankTargetRotation,
-                                       TANK_MAX_ROTATION_SECONDS * deltaSeconds );
+                                       TANK_MAX_ROTATION_SECONDS * deltaSeconds ) );
 
     m_TurrentCurrentOffset = GetTurnedTowards( m_TurrentCurrentOffset,
                                                m_TurrentTargetOffset,
                                                (TANK_MAX_ROTATION_SECONDS + TANK_TURRENT_MAX_ROTATION_SECONDS) * deltaSeconds );
 
     Entity::Update( deltaSeconds );
-
-    ClampVelocity();
 }
 
 void PlayerCharacter::Render() const
@@ -78,7 +72,7 @@ void PlayerCharacter::Render() const
 void PlayerCharacter::Die()
 {
     g_AudioSystem->PlaySound( AUDIO_PLAYER_DIED );
-    m_CurrentMap->SpawnNewExplosion( m_Position, 1.75f, m_Scale * 1.5f );
+    m_CurrentMap->RequestSpawnExplosion( GetPosition(), 1.75f, m_Scale * 1.5f );
     m_GameInstance->PlayerDied();
 }
 
@@ -91,9 +85,9 @@ void PlayerCharacter::RespawnResetStats()
     m_Health = TANK_PLAYER_HEALTH;
     m_IsDead = false;
 
-    m_Velocity = Vec3::ZERO;
+    SetVelocity( Vec3::ZERO );
 
-    m_AngleDegrees = 0.f;
+    SetAngleDegrees( 0.f );
     m_TankTargetRotation = 0.f;
 
     m_TurrentCurrentOffset = 0.f;
@@ -102,7 +96,7 @@ void PlayerCharacter::RespawnResetStats()
 
 void PlayerCharacter::TeleportToNewMap( Map* newMap )
 {
-    m_CurrentMap = newMap;
+    MoveToMap( newMap );
 }
 
 void PlayerCharacter::HandleUserInput()
@@ -159,17 +153,17 @@ void PlayerCharacter::HandleUserInput()
     if ( tankTargetPosition != Vec2::ZERO )
     {
         m_TankTargetRotation = tankTargetPosition.GetAngleDegrees();
-        SetVelocity( Vec3::MakeFromPolarDegreesXY( m_AngleDegrees, TANK_MAX_VELOCITY ) );
+        SetVelocity( Vec3::MakeFromPolarDegreesXY( GetAngleDegrees(), TANK_MAX_VELOCITY ) );
     }
     else
     {
-        m_TankTargetRotation = m_AngleDegrees;
+        m_TankTargetRotation = GetAngleDegrees();
         SetVelocity( Vec3::ZERO );
     }
 
     if ( turrentTargetPosition != Vec2::ZERO )
     {
-        m_TurrentTargetOffset = turrentTargetPosition.GetAngleDegrees() - m_AngleDegrees;
+        m_TurrentTargetOffset = turrentTargetPosition.GetAngleDegrees() - GetAngleDegrees();
     }
     else
     {
@@ -191,13 +185,13 @@ void PlayerCharacter::HandleGamepadInput()
 
             m_TankTargetRotation = leftJoystick.GetAngleDegrees();
 
-            SetVelocity( Vec3::MakeFromPolarDegreesXY( m_AngleDegrees,
+            SetVelocity( Vec3::MakeFromPolarDegreesXY( GetAngleDegrees(),
                                                        TANK_MAX_VELOCITY * leftJoystick.GetMagnitude() )
             );
         }
         else if ( !g_InputSystem->IsAnyKeyDown() )
         {
-            m_TankTargetRotation = m_AngleDegrees;
+            m_TankTargetRotation = GetAngleDegrees();
 
             SetVelocity( Vec3::ZERO );
         }
@@ -206,7 +200,7 @@ void PlayerCharacter::HandleGamepadInput()
         {
             const AnalogJoystick& rightJoystick = gamepad.GetRightJoystick();
 
-            m_TurrentTargetOffset = rightJoystick.GetAngleDegrees() - m_AngleDegrees;
+            m_TurrentTargetOffset = rightJoystick.GetAngleDegrees() - GetAngleDegrees();
         }
         else if ( !g_InputSystem->IsAnyKeyDown() )
         {
@@ -228,37 +222,32 @@ void PlayerCharacter::HandleGamepadInput()
     }
 }
 
-void PlayerCharacter::ClampVelocity()
-{
-    m_Velocity.ClampLength( TANK_MAX_VELOCITY );
-}
-
 void PlayerCharacter::ShootBullet()
 {
-    Vec2 spawnPosition = static_cast<Vec2>(m_Position) +
-        Vec2::MakeFromPolarDegrees( m_AngleDegrees + m_TurrentCurrentOffset,
+    Vec2 spawnPosition = static_cast<Vec2>(GetPosition()) +
+        Vec2::MakeFromPolarDegrees( GetAngleDegrees() + m_TurrentCurrentOffset,
         (m_TurrentBoundingBoxUnits.x * .375f) + m_TurrentVisualOffset.x );
 
-    float bulletDireciton = m_AngleDegrees + m_TurrentCurrentOffset;
-    Bullet* bullet = ( Bullet*) m_CurrentMap->SpawnNewEntity( ENTITY_BULLET_ALLIED,
-                                                              spawnPosition );
-    bullet->SetBulletDireciton( Vec2::MakeFromPolarDegrees( bulletDireciton ) );
+    float bulletDireciton = GetAngleDegrees() + m_TurrentCurrentOffset;
+    m_CurrentMap->RequestSpawnBullet( ENTITY_BULLET_ALLIED,
+                                      static_cast<Vec3>(spawnPosition),
+                                      Vec2::MakeFromPolarDegrees( bulletDireciton ) );
 
-    m_CurrentMap->SpawnNewExplosion( static_cast<Vec3>(spawnPosition),
-                                     .25f,
-                                     Vec3( .25f, .25f, .25f ) );
+    m_CurrentMap->RequestSpawnExplosion( static_cast<Vec3>(spawnPosition),
+                                         .25f,
+                                         Vec3( .25f, .25f, .25f ) );
 
     g_AudioSystem->PlaySound( AUDIO_PLAYER_SHOOT );
 }
 
 void PlayerCharacter::RenderTankBody() const
 {
-    std::vector<VertexMaster> bodyVisual;
+    std::vector<VertexMaster>& bodyVisual = g_FrameArena->AllocateVertexList();
     AABB2 boundingBox = AABB2::UNIT_AROUND_ZERO;
     boundingBox.SetDimensions( m_BoundingBoxUnits );
     AppendAABB2( bodyVisual, boundingBox, Rgba8::WHITE );
 
-    TransformVertexArray( bodyVisual, static_cast<Vec2>(m_Position), m_AngleDegrees, static_cast<Vec2>(m_Scale) );
+    TransformVertexArray( bodyVisual, static_cast<Vec2>(GetPosition()), GetAngleDegrees(), static_cast<Vec2>(m_Scale) );
     g_Renderer->BindTexture( m_Texture );
     g_Renderer->DrawVertexArray( bodyVisual );
 
@@ -279,29 +268,29 @@ void PlayerCharacter::RenderTankBody() const
         lifeColor = Rgba8::RED;
     }
 
-    std::vector<VertexMaster> lifeVisual;
+    std::vector<VertexMaster>& lifeVisual = g_FrameArena->AllocateVertexList();
     g_FontDefault->AddVertsForText( lifeVisual,
                                     life,
                                     Vec2(-1.2f, -1.f),
                                     .4f,
                                     lifeColor,
                                     .25f );
-    TransformVertexArray( lifeVisual, static_cast<Vec2>(m_Position), 0.f, 1.f );
+    TransformVertexArray( lifeVisual, static_cast<Vec2>(GetPosition()), 0.f, 1.f );
     g_Renderer->BindTexture( g_FontDefault->GetTexture() );
     g_Renderer->DrawVertexArray( lifeVisual );
 }
 
 void PlayerCharacter::RenderTankTurrent() const
 {
-    std::vector<VertexMaster> turrentVisual;
+    std::vector<VertexMaster>& turrentVisual = g_FrameArena->AllocateVertexList();
     AppendAABB2( turrentVisual,
                             AABB2::MakeFromAspect( m_TurrentTexture->GetAspectRatio() ),
                             Rgba8::WHITE );
 
-    Vec3 correctedPosition = m_Position;
-    correctedPosition += static_cast<Vec3>(m_TurrentVisualOffset.GetRotatedDegrees( m_AngleDegrees + m_TurrentCurrentOffset ));
+    Vec3 correctedPosition = GetPosition();
+    correctedPosition += static_cast<Vec3>(m_TurrentVisualOffset.GetRotatedDegrees( GetAngleDegrees() + m_TurrentCurrentOffset ));
 
-    TransformVertexArray( turrentVisual, static_cast<Vec2>(correctedPosition), m_AngleDegrees + m_TurrentCurrentOffset, 1.f );
+    TransformVertexArray( turrentVisual, static_cast<Vec2>(correctedPosition), GetAngleDegrees() + m_TurrentCurrentOffset, 1.f );
     g_Renderer->BindTexture( m_TurrentTexture );
     g_Renderer->DrawVertexArray( turrentVisual );
 }
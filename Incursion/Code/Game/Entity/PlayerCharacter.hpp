@@ -26,7 +26,6 @@ private:
     void HandleUserInput();
     void HandleGamepadInput();
 
-    void ClampVelocity();
 
     void ShootBullet();
 
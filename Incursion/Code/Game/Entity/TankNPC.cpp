@@ -7,6 +7,7 @@
 #include "Engine/Core/Math/RandomNumberGenerator.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 #include "Game/World.hpp"
 #include "Game/AssetManagers/AudioManager.hpp"
@@ -33,13 +34,7 @@ TankNPC::TankNPC( Game* gameInstance,
 
     m_Texture = g_Renderer->CreateOrGetTextureFromFile( SPRITE_ENEMY_TANK );
 
-    m_OverlapsTiles = true;
-    m_IsPushedByWalls = true;
-    m_OverlapsEntities = true;
-    m_IsFixed = false;
-    m_IsPushedByEntities = true;
-    m_DoesPushEntities = true;
-    m_IsHitByBullets = true;
+    SetPhysicsFlagsFromType();
 
     m_DamageSoundInitiallized = true;
     m_DamageSound = AUDIO_ENEMY_HIT;
@@ -64,19 +59,19 @@ void TankNPC::Render() const
 {
     if ( m_IsDead ) { return; }
 
-    std::vector<VertexMaster> bodyVisual;
+    std::vector<VertexMaster>& bodyVisual = g_FrameArena->AllocateVertexList();
     AABB2 boundingBox = AABB2::UNIT_AROUND_ZERO;
     boundingBox.SetDimensions( m_BoundingBoxUnits );
     AppendAABB2( bodyVisual, boundingBox, Rgba8::WHITE );
 
-    TransformVertexArray( bodyVisual, static_cast<Vec2>(m_Position), m_AngleDegrees, static_cast<Vec2>(m_Scale) );
+    TransformVertexArray( bodyVisual, static_cast<Vec2>(GetPosition()), GetAngleDegrees(), static_cast<Vec2>(m_Scale) );
     g_Renderer->BindTexture( m_Texture );
     g_Renderer->DrawVertexArray( bodyVisual );
 }
 
 void TankNPC::DebugRender() const
 {
-    Vec2 pos2 = static_cast<Vec2>(m_Position);
+    Vec2 pos2 = static_cast<Vec2>(GetPosition());
     if ( m_TankState == TankAIState::PURSUE ||
          m_TankState == TankAIState::ATTACK )
     {
@@ -100,7 +95,7 @@ void TankNPC::Die()
 {
     g_AudioSystem->PlaySound( AUDIO_ENEMY_DIED );
 
-    m_CurrentMap->SpawnNewExplosion( m_Position, 1.f, m_Scale );
+    m_CurrentMap->RequestSpawnExplosion( GetPosition(), 1.f, m_Scale );
 }
 
 void TankNPC::Destroy()
@@ -124,16 +119,16 @@ void TankNPC::TankAI( float deltaSeconds )
             break;
     }
 
-    m_AngleDegrees = GetTurnedTowards( m_AngleDegrees,
+    SetAngleDegrees( GetTurnedTowards( GetAngleDegrees(),
                                        m_TargetOrientation,
-                                       TANK_MAX_ROTATION_SECONDS * deltaSeconds );
+                                       TANK_MAX_ROTATION_SECONDS * deltaSeconds ) );
 }
 
 void TankNPC::WanderBehavior( float deltaSeconds )
 {
     UNUSED( deltaSeconds );
 
-    if ( IsPlayerVisable() )
+    if ( FindVisibleTarget() != nullptr )
     {
         m_TankState = TankAIState::ATTACK;
         return;
@@ -141,32 +136,47 @@ void TankNPC::WanderBehavior( float deltaSeconds )
 
     Navigate( deltaSeconds );
 
-    SetVelocity( Vec3::MakeFromPolarDegreesXY( m_AngleDegrees, TANK_NPC_MAX_VELOCITY ) );
+    SetVelocity( Vec3::MakeFromPolarDegreesXY( GetAngleDegrees(), TANK_NPC_MAX_VELOCITY ) );
 }
 
-void TankNPC::Navigate( float deltaSeconds )
+//-----------------------------------------------------------------------------
+// 0 when the wisker clears the wall, up to 1 when the wall is at the tank.
+// Each wisker treats the wall nearest its own midpoint as a plane, so walls
+// on both sides of a corridor don't cancel out
+static float GetWiskerDepth( const Map& map, const Vec2& position, float wiskerDegrees )
 {
-    Vec2 pos2 = static_cast<Vec2>(m_Position);
-    RayCastHit leftWisker = m_CurrentMap->RayCastSolid( pos2,
-                                                        m_TargetOrientation + TANK_NPC_WISKER_ANGLE,
-                                                        TANK_NPC_WISKER_DIST );
-    RayCastHit rightWisker = m_CurrentMap->RayCastSolid( static_cast<Vec2>(m_Position),
-                                                         m_TargetOrientation - TANK_NPC_WISKER_ANGLE,
-                                                         TANK_NPC_WISKER_DIST );
+    Vec2 wiskerDirection = Vec2::MakeFromPolarDegrees( wiskerDegrees );
+    Vec2 wiskerMidpoint = position + wiskerDirection * (.5f * TANK_NPC_WISKER_DIST);
+    Vec2 towardWall = -map.GetWallNormal( wiskerMidpoint );
+
+    float wiskerFacingWall = DotProduct2D( wiskerDirection, towardWall );
+    if( wiskerFacingWall <= 0.f ) { return 0.f; }
+
+    // Carry the plane back from the midpoint to the tank
+    float wallDistance = map.GetWallDistance( wiskerMidpoint ) + (.5f * TANK_NPC_WISKER_DIST) * wiskerFacingWall;
+
+    float percentToWall = ClampZeroToOne( (wallDistance / wiskerFacingWall) / TANK_NPC_WISKER_DIST );
+    return 1.f - percentToWall;
+}
 
-    float leftPercent = 1.f - leftWisker.percentToFinish;
-    float rightPercent = 1.f - rightWisker.percentToFinish;
+void TankNPC::Navigate( float deltaSeconds )
+{
+    // Find where each wisker would cross its nearest wall, rather than
+    // marching the wiskers through the tiles
+    Vec2 pos2 = static_cast<Vec2>(GetPosition());
+    float leftPercent = GetWiskerDepth( *m_CurrentMap, pos2, m_TargetOrientation + TANK_NPC_WISKER_ANGLE );
+    float rightPercent = GetWiskerDepth( *m_CurrentMap, pos2, m_TargetOrientation - TANK_NPC_WISKER_ANGLE );
 
     bool deepWisker = false;
     if ( leftPercent > .4f || rightPercent > .4f )
     {
-        m_VelocityModifier = .25f;
+        SetVelocityModifier( .25f );
         deepWisker = true;
     }
     bool doubleDeepWisker = false;
     if ( leftPercent > .4f && rightPercent > .4f )
     {
-        m_VelocityModifier = .1f;
+        SetVelocityModifier( .1f );
         doubleDeepWisker = true;
     }
     
@@ -203,19 +213,27 @@ void TankNPC::PursueBehavior( float deltaSeconds )
 {
     UNUSED( deltaSeconds );
 
-    if ( IsPlayerVisable() )
+    if ( FindVisibleTarget() != nullptr )
     {
         m_TankState = TankAIState::ATTACK;
         return;
     }
 
+    // Nothing to chase once the target died or left the map
+    const Entity* target = m_CurrentMap->GetEntity( m_TargetHandle );
+    if ( target == nullptr || target->IsDead() )
+    {
+        m_TankState = TankAIState::WANDER;
+        return;
+    }
+
     if ( GetEntityPhysicsDisc().IsPointInside( m_LastSeenPosition ) )
     {
         m_TankState = TankAIState::WANDER;
         return;
     }
 
-    float angleToPoint = (m_LastSeenPosition - static_cast<Vec2>(m_Position)).GetAngleDegrees();
+    float angleToPoint = (m_LastSeenPosition - static_cast<Vec2>(GetPosition())).GetAngleDegrees();
     SetVelocity( Vec3::MakeFromPolarDegreesXY( angleToPoint, TANK_NPC_MAX_VELOCITY ) );
 }
 
@@ -223,28 +241,28 @@ void TankNPC::AttackBehavior( float deltaSeconds )
 {
     UNUSED( deltaSeconds );
 
-    if ( !IsPlayerVisable() )
+    Entity* target = FindVisibleTarget();
+    if ( target == nullptr )
     {
         m_TankState = TankAIState::PURSUE;
         return;
     }
 
-    Entity* player = ( Entity*) (g_GameInstance->GetCurrentWorld()->GetPlayerCharacter());
-
-    m_LastSeenPosition = static_cast<Vec2>(player->GetPosition());
+    m_TargetHandle = target->GetHandle();
+    m_LastSeenPosition = static_cast<Vec2>(target->GetPosition());
 
-    m_TargetOrientation = (player->GetPosition() - m_Position).GetAngleAboutZDegrees();
+    m_TargetOrientation = (target->GetPosition() - GetPosition()).GetAngleAboutZDegrees();
 
-    if ( abs( GetShortestAngularDisplacement( m_TargetOrientation, m_AngleDegrees ) ) < TANK_NPC_FOLLOW_APETURE )
+    if ( abs( GetShortestAngularDisplacement( m_TargetOrientation, GetAngleDegrees() ) ) < TANK_NPC_FOLLOW_APETURE )
     {
-        SetVelocity( Vec3::MakeFromPolarDegreesXY( m_AngleDegrees, TANK_NPC_MAX_VELOCITY ) );
+        SetVelocity( Vec3::MakeFromPolarDegreesXY( GetAngleDegrees(), TANK_NPC_MAX_VELOCITY ) );
     }
     else
     {
         SetVelocity( Vec3::ZERO );
     }
 
-    if ( abs( GetShortestAngularDisplacement( m_TargetOrientation, m_AngleDegrees ) ) < TANK_NPC_ENGAGE_APETURE )
+    if ( abs( GetShortestAngularDisplacement( m_TargetOrientation, GetAngleDegrees() ) ) < TANK_NPC_ENGAGE_APETURE )
     {
         if ( m_LastShotCheck + TANK_NPC_RELOAD_SPEED < m_Age )
         {
@@ -257,30 +275,26 @@ void TankNPC::AttackBehavior( float deltaSeconds )
 
 void TankNPC::ShootBullet()
 {
-    Vec2 spawnPosition = static_cast<Vec2>(m_Position) +
-        Vec2::MakeFromPolarDegrees( m_AngleDegrees, .5f );
+    Vec2 spawnPosition = static_cast<Vec2>(GetPosition()) +
+        Vec2::MakeFromPolarDegrees( GetAngleDegrees(), .5f );
 
-    float bulletDireciton = m_AngleDegrees;
+    float bulletDireciton = GetAngleDegrees();
     EntityType bulletType = m_EntityFaction == FACTION_PLAYER ? ENTITY_BULLET_ALLIED : ENTITY_BULLET_ENEMY;
-    Bullet* bullet = ( Bullet*) m_CurrentMap->SpawnNewEntity( bulletType,
-                                                              spawnPosition );
+    m_CurrentMap->RequestSpawnBullet( bulletType,
+                                      static_cast<Vec3>(spawnPosition),
+                                      Vec2::MakeFromPolarDegrees( bulletDireciton ) );
 
-    bullet->SetBulletDireciton( Vec2::MakeFromPolarDegrees( bulletDireciton ) );
-
-    m_CurrentMap->SpawnNewExplosion( static_cast<Vec3>(spawnPosition), 
-                                     .25f, 
-                                     Vec3( .25f, .25f, .25f ) );
+    m_CurrentMap->RequestSpawnExplosion( static_cast<Vec3>(spawnPosition), 
+                                         .25f, 
+                                         Vec3( .25f, .25f, .25f ) );
 
     g_AudioSystem->PlaySound( AUDIO_ENEMY_SHOOT );
 }
 
-bool TankNPC::IsPlayerVisable()
+// Nearest hostile tank, turret or player in view
+Entity* TankNPC::FindVisibleTarget() const
 {
-    Entity* player = ( Entity*) (m_GameInstance->GetCurrentWorld()->GetPlayerCharacter());
-    if ( player == nullptr ) { return false; }
-    if ( player->IsDead() ) { return false; }
-
-    return m_CurrentMap->HasLineOfSight( *this, *player, TANK_NPC_VIEW_DISTANCE );
+    return m_CurrentMap->FindNearestVisibleEntity( *this, TANK_NPC_VIEW_DISTANCE, MakeHostileCombatantFilter( m_EntityFaction ) );
 }
 
 float TankNPC::NewTargetOrientation()
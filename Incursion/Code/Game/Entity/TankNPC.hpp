@@ -33,6 +33,7 @@ private:
 
     TankAIState m_TankState = TankAIState::WANDER;
     Vec2 m_LastSeenPosition = Vec2::ZERO;
+    EntityHandle m_TargetHandle;        // Last target attacked, kept while pursuing
 
     void TankAI( float deltaSeconds );
 
@@ -43,7 +44,7 @@ private:
 
     void ShootBullet();
 
-    bool IsPlayerVisable();
+    Entity* FindVisibleTarget() const;
 
     float NewTargetOrientation();
 };
\ No newline at end of file
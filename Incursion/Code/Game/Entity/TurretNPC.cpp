@@ -7,6 +7,7 @@
 #include "Engine/Renderer/RenderContext.hpp"
 #include "Engine/Renderer/Texture.hpp"
 
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
 #include "Game/World.hpp"
 #include "Game/AssetManagers/AudioManager.hpp"
@@ -37,13 +38,7 @@ TurretNPC::TurretNPC( Game* gameInstance,
     m_Texture = g_Renderer->CreateOrGetTextureFromFile( SPRITE_ENEMY_TURRENT_BASE );
     m_TurretTexture = g_Renderer->CreateOrGetTextureFromFile( SPRITE_ENEMY_TURRENT_TOP );
 
-    m_OverlapsTiles = false;
-    m_IsPushedByWalls = true;
-    m_OverlapsEntities = true;
-    m_IsFixed = true;
-    m_IsPushedByEntities = false;
-    m_DoesPushEntities = true;
-    m_IsHitByBullets = true;
+    SetPhysicsFlagsFromType();
 
     m_DamageSoundInitiallized = true;
     m_DamageSound = AUDIO_ENEMY_HIT;
@@ -61,8 +56,8 @@ void TurretNPC::Update( float deltaSeconds )
 
     m_RayTraceResult = g_GameInstance->GetCurrentWorld()->
         GetCurrentMap()->
-        RayCastVisual( static_cast<Vec2>(m_Position),
-                       m_AngleDegrees,
+        RayCastVisual( static_cast<Vec2>(GetPosition()),
+                       GetAngleDegrees(),
                        TURRET_NPC_VIEW_DISTANCE );
 
     Entity::Update( deltaSeconds );
@@ -75,8 +70,8 @@ void TurretNPC::Render() const
     RenderBase();
     RenderTurrent();
 
-    std::vector<VertexMaster> lineVisual;
-    AppendLineSeg2DToVectorMaster( lineVisual, LineSeg2D( static_cast<Vec2>( m_Position ), m_RayTraceResult.hitPosition ), Rgba8::RED, .01f );
+    std::vector<VertexMaster>& lineVisual = g_FrameArena->AllocateVertexList();
+    AppendLineSeg2DToVectorMaster( lineVisual, LineSeg2D( static_cast<Vec2>( GetPosition() ), m_RayTraceResult.hitPosition ), Rgba8::RED, .01f );
 
     g_Renderer->BindTexture( nullptr );
     g_Renderer->DrawVertexArray( lineVisual );
@@ -86,7 +81,7 @@ void TurretNPC::Die()
 {
     g_AudioSystem->PlaySound( AUDIO_ENEMY_DIED );
 
-    m_CurrentMap->SpawnNewExplosion( m_Position, 1.25f, m_Scale * 1.25f );
+    m_CurrentMap->RequestSpawnExplosion( GetPosition(), 1.25f, m_Scale * 1.25f );
 }
 
 void TurretNPC::Destroy()
@@ -95,24 +90,24 @@ void TurretNPC::Destroy()
 
 void TurretNPC::RenderBase() const
 {
-    std::vector<VertexMaster> baseVisual;
+    std::vector<VertexMaster>& baseVisual = g_FrameArena->AllocateVertexList();
     AABB2 boundingBox = AABB2::UNIT_AROUND_ZERO;
     boundingBox.SetDimensions( m_BoundingBoxUnits );
     AppendAABB2( baseVisual, boundingBox, Rgba8::WHITE );
 
-    TransformVertexArray( baseVisual, static_cast<Vec2>(m_Position), 0.f, 1.f );
+    TransformVertexArray( baseVisual, static_cast<Vec2>(GetPosition()), 0.f, 1.f );
     g_Renderer->BindTexture( m_Texture );
     g_Renderer->DrawVertexArray( baseVisual );
 }
 
 void TurretNPC::RenderTurrent() const
 {
-    std::vector<VertexMaster> bodyVisual;
+    std::vector<VertexMaster>& bodyVisual = g_FrameArena->AllocateVertexList();
     AABB2 boundingBox = AABB2::UNIT_AROUND_ZERO;
     boundingBox.SetDimensions( m_BoundingBoxUnits );
     AppendAABB2( bodyVisual, boundingBox, Rgba8::WHITE );
 
-    TransformVertexArray( bodyVisual, static_cast<Vec2>(m_Position), m_AngleDegrees, 1.f );
+    TransformVertexArray( bodyVisual, static_cast<Vec2>(GetPosition()), GetAngleDegrees(), 1.f );
     g_Renderer->BindTexture( m_TurretTexture );
     g_Renderer->DrawVertexArray( bodyVisual );
 }
@@ -174,58 +169,64 @@ void TurretNPC::TurretAI( float deltaSeconds )
 
 void TurretNPC::ScanBahavior( float deltaSeconds )
 {
-    if ( IsPlayerVisable() )
+    if ( FindVisibleTarget() != nullptr )
     {
         m_TurretState = TurretAIState::ATTACK;
         return;
     }
 
     m_TargetOrientation += TURRET_NPC_MAX_ROTATION_SECONDS_PATROL * deltaSeconds;
-    m_AngleDegrees = GetTurnedTowards( m_AngleDegrees,
+    SetAngleDegrees( GetTurnedTowards( GetAngleDegrees(),
                                        m_TargetOrientation,
-                                       TURRET_NPC_MAX_ROTATION_SECONDS_PATROL * deltaSeconds );
+                                       TURRET_NPC_MAX_ROTATION_SECONDS_PATROL * deltaSeconds ) );
 }
 
 void TurretNPC::WatchBehavior( float deltaSeconds )
 {
-    if ( IsPlayerVisable() )
+    if ( FindVisibleTarget() != nullptr )
     {
         m_TurretState = TurretAIState::ATTACK;
         return;
     }
 
-    if ( m_GameInstance->GetCurrentWorld()->GetPlayerCharacter()->IsDead() )
+    // Keeps watching until the last target died or left the map
+    const Entity* target = m_CurrentMap->GetEntity( m_TargetHandle );
+    if ( target == nullptr || target->IsDead() )
     {
         m_TurretState = TurretAIState::SCAN;
         return;
     }
 
-    float shortest = GetShortestAngularDisplacement( m_LastSeenAngle, m_AngleDegrees );
+    float shortest = GetShortestAngularDisplacement( m_LastSeenAngle, GetAngleDegrees() );
     if ( abs( shortest ) >= TURRET_NPC_WATCH_APETURE_HALF )
     {
-        m_TurnDirection = GetAngleDirectionTowards( m_AngleDegrees, m_TargetOrientation );
+        m_TurnDirection = GetAngleDirectionTowards( GetAngleDegrees(), m_TargetOrientation );
     }
 
-    m_AngleDegrees += m_TurnDirection * TURRET_NPC_MAX_ROTATION_SECONDS_ENGAGED * deltaSeconds;
+    AddAngleDegrees( m_TurnDirection * TURRET_NPC_MAX_ROTATION_SECONDS_ENGAGED * deltaSeconds );
 }
 
 void TurretNPC::AttackBehavior( float deltaSeconds )
 {
-    if ( !IsPlayerVisable() )
+    Entity* target = FindVisibleTarget();
+    if ( target == nullptr )
     {
         m_TurretState = TurretAIState::WATCH;
         return;
     }
     // Sets the tile visable if the player is being targeted
-    m_CurrentMap->SetTilePositionVisable( static_cast<IntVec2>(static_cast<Vec2>(m_Position)) );
+    if ( target->GetEntityType() == ENTITY_PLAYER )
+    {
+        m_CurrentMap->SetTilePositionVisable( static_cast<IntVec2>(static_cast<Vec2>(GetPosition())) );
+    }
 
-    Entity* player = ( Entity*) (g_GameInstance->GetCurrentWorld()->GetPlayerCharacter());
-    m_TargetOrientation = (player->GetPosition() - m_Position).GetAngleAboutZDegrees();
+    m_TargetHandle = target->GetHandle();
+    m_TargetOrientation = (target->GetPosition() - GetPosition()).GetAngleAboutZDegrees();
 
     m_LastSeenAngle = m_TargetOrientation;
-    m_TurnDirection = m_TargetOrientation > m_AngleDegrees ? 1 : -1;
+    m_TurnDirection = m_TargetOrientation > GetAngleDegrees() ? 1 : -1;
 
-    if ( abs( GetShortestAngularDisplacement( m_TargetOrientation, m_AngleDegrees ) ) < TURRET_NPC_ENGAGE_APETURE )
+    if ( abs( GetShortestAngularDisplacement( m_TargetOrientation, GetAngleDegrees() ) ) < TURRET_NPC_ENGAGE_APETURE )
     {
         if ( m_LastShotCheck + TURRET_NPC_RELOAD_SPEED < m_Age )
         {
@@ -235,34 +236,31 @@ void TurretNPC::AttackBehavior( float deltaSeconds )
         }
     }
 
-    m_AngleDegrees = GetTurnedTowards( m_AngleDegrees,
+    SetAngleDegrees( GetTurnedTowards( GetAngleDegrees(),
                                        m_TargetOrientation,
-                                       TURRET_NPC_MAX_ROTATION_SECONDS_ENGAGED * deltaSeconds );
+                                       TURRET_NPC_MAX_ROTATION_SECONDS_ENGAGED * deltaSeconds ) );
 }
 
 void TurretNPC::ShootBullet()
 {
-    Vec2 spawnPosition = static_cast<Vec2>(m_Position) +
-        Vec2::MakeFromPolarDegrees( m_AngleDegrees, .5f );
+    Vec2 spawnPosition = static_cast<Vec2>(GetPosition()) +
+        Vec2::MakeFromPolarDegrees( GetAngleDegrees(), .5f );
 
-    float bulletDireciton = m_AngleDegrees;
+    float bulletDireciton = GetAngleDegrees();
     EntityType bulletType = m_EntityFaction == FACTION_PLAYER ? ENTITY_BULLET_ALLIED : ENTITY_BULLET_ENEMY;
-    Bullet* bullet = ( Bullet*) m_CurrentMap->SpawnNewEntity( bulletType,
-                                                              spawnPosition );
-    bullet->SetBulletDireciton( Vec2::MakeFromPolarDegrees( bulletDireciton ) );
+    m_CurrentMap->RequestSpawnBullet( bulletType,
+                                      static_cast<Vec3>(spawnPosition),
+                                      Vec2::MakeFromPolarDegrees( bulletDireciton ) );
 
-    m_CurrentMap->SpawnNewExplosion( static_cast<Vec3>(spawnPosition), 
-                                     .25f, 
-                                     Vec3( .25f, .25f, .25f ) );
+    m_CurrentMap->RequestSpawnExplosion( static_cast<Vec3>(spawnPosition), 
+                                         .25f, 
+                                         Vec3( .25f, .25f, .25f ) );
 
     g_AudioSystem->PlaySound( AUDIO_ENEMY_SHOOT );
 }
 
-bool TurretNPC::IsPlayerVisable()
+// Nearest hostile tank, turret or player in view
+Entity* TurretNPC::FindVisibleTarget() const
 {
-    Entity* player = ( Entity*) (m_GameInstance->GetCurrentWorld()->GetPlayerCharacter());
-    if ( player == nullptr ) { return false; }
-    if ( player->IsDead() ) { return false; }
-
-    return m_CurrentMap->HasLineOfSight( *this, *player, TURRET_NPC_VIEW_DISTANCE );
+    return m_CurrentMap->FindNearestVisibleEntity( *this, TURRET_NPC_VIEW_DISTANCE, MakeHostileCombatantFilter( m_EntityFaction ) );
 }
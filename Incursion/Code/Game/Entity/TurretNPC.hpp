@@ -38,6 +38,7 @@ private:
 
     TurretAIState m_TurretState = TurretAIState::SCAN;
     float m_LastSeenAngle = 0.f;
+    EntityHandle m_TargetHandle;        // Last target attacked, kept while watching
     int m_TurnDirection = 1;
 
     void TurretAI( float deltaSeconds );
@@ -47,5 +48,5 @@ private:
 
     void ShootBullet();
 
-    bool IsPlayerVisable();
+    Entity* FindVisibleTarget() const;
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "FrameArena.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "Engine/Renderer/Mesh/MeshUtils.hpp"
+
+//-----------------------------------------------------------------------------
+FrameArena::FrameArena( size_t capacityBytes )
+    : m_Capacity( capacityBytes )
+{
+    m_Buffer = static_cast<unsigned char*>(std::malloc( capacityBytes ));
+}
+
+FrameArena::~FrameArena()
+{
+    Reset();
+    std::free( m_Buffer );
+    m_Buffer = nullptr;
+
+    for( int listIndex = 0; listIndex < m_VertexLists.size(); ++listIndex )
+    {
+        delete m_VertexLists[ listIndex ];
+    }
+    m_VertexLists.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FrameArena::Reset()
+{
+    m_LastFrameBytesUsed = m_BytesUsed;
+    m_LastFrameOverflowAllocations = static_cast<int>(m_OverflowBlocks.size());
+
+    for( int blockIndex = 0; blockIndex < m_OverflowBlocks.size(); ++blockIndex )
+    {
+        std::free( m_OverflowBlocks[ blockIndex ] );
+    }
+    m_OverflowBlocks.clear();
+
+    m_Offset = 0;
+    m_BytesUsed = 0;
+    m_NumVertexListsUsed = 0;
+}
+
+void* FrameArena::Allocate( size_t numBytes, size_t alignment )
+{
+    m_BytesUsed += numBytes;
+    if( m_BytesUsed > m_HighWaterBytes ) { m_HighWaterBytes = m_BytesUsed; }
+
+    uintptr_t bufferAddress = reinterpret_cast<uintptr_t>(m_Buffer);
+    uintptr_t alignedAddress = (bufferAddress + m_Offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    size_t alignedOffset = static_cast<size_t>(alignedAddress - bufferAddress);
+    if( alignedOffset + numBytes <= m_Capacity )
+    {
+        m_Offset = alignedOffset + numBytes;
+        return m_Buffer + alignedOffset;
+    }
+
+    // malloc is aligned for any fundamental type, which covers every STL use
+    void* overflowBlock = std::malloc( numBytes );
+    m_OverflowBlocks.push_back( overflowBlock );
+    return overflowBlock;
+}
+
+std::vector<VertexMaster>& FrameArena::AllocateVertexList()
+{
+    if( m_NumVertexListsUsed == m_VertexLists.size() )
+    {
+        m_VertexLists.push_back( new std::vector<VertexMaster>() );
+    }
+
+    std::vector<VertexMaster>& vertexList = *m_VertexLists[ m_NumVertexListsUsed++ ];
+    vertexList.clear();
+    return vertexList;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+struct VertexMaster;
+template<typename T> class FrameAllocator;
+
+//-----------------------------------------------------------------------------
+// Bump allocator for memory that only lives until the end of the frame. The
+// App resets it at the start of every frame, nothing is freed before then.
+// Allocations past the arena's capacity fall back to the heap and are freed
+// on the next reset, the high water mark shows how big the arena should be.
+// Only the main thread may use it.
+class FrameArena
+{
+public:
+    explicit FrameArena( size_t capacityBytes );
+    ~FrameArena();
+    FrameArena( const FrameArena& ) = delete;
+    FrameArena& operator=( const FrameArena& ) = delete;
+
+    void Reset();
+
+    void* Allocate( size_t numBytes, size_t alignment );
+    template<typename T>
+    FrameAllocator<T> GetAllocator()            { return FrameAllocator<T>( this ); }
+
+    // Empty vertex list for building a mesh this frame. The engine's vertex
+    // helpers only take std::vector, so these are kept between frames
+    // instead of living in the arena, and come back empty but with their
+    // capacity after a reset.
+    std::vector<VertexMaster>& AllocateVertexList();
+
+    size_t GetCapacity() const                  { return m_Capacity; }
+    size_t GetBytesUsed() const                 { return m_BytesUsed; }
+    size_t GetLastFrameBytesUsed() const        { return m_LastFrameBytesUsed; }
+    size_t GetHighWaterBytes() const            { return m_HighWaterBytes; }
+    int GetNumOverflowAllocations() const       { return static_cast<int>(m_OverflowBlocks.size()); }
+    int GetLastFrameOverflowAllocations() const { return m_LastFrameOverflowAllocations; }
+    int GetNumVertexListsUsed() const           { return m_NumVertexListsUsed; }
+    int GetVertexListHighWater() const          { return static_cast<int>(m_VertexLists.size()); }
+
+private:
+    unsigned char* m_Buffer = nullptr;
+    size_t m_Capacity = 0;
+    size_t m_Offset = 0;
+
+    // Bytes handed out this frame, overflow included
+    size_t m_BytesUsed = 0;
+    size_t m_LastFrameBytesUsed = 0;
+    size_t m_HighWaterBytes = 0;
+    std::vector<void*> m_OverflowBlocks;
+    int m_LastFrameOverflowAllocations = 0;
+
+    std::vector<std::vector<VertexMaster>*> m_VertexLists;
+    int m_NumVertexListsUsed = 0;
+};
+
+//-----------------------------------------------------------------------------
+// STL allocator over a FrameArena, for containers that don't outlive the
+// frame. Deallocation does nothing, so reserve up front where possible.
+template<typename T>
+class FrameAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit FrameAllocator( FrameArena* arena ) : m_Arena( arena ) {}
+    template<typename OTHER_TYPE>
+    FrameAllocator( const FrameAllocator<OTHER_TYPE>& other ) : m_Arena( other.GetArena() ) {}
+
+    T* allocate( size_t count )             { return static_cast<T*>(m_Arena->Allocate( count * sizeof( T ), alignof(T) )); }
+    void deallocate( T*, size_t )           {}
+
+    FrameArena* GetArena() const            { return m_Arena; }
+
+private:
+    FrameArena* m_Arena = nullptr;
+};
+
+template<typename T1, typename T2>
+bool operator==( const FrameAllocator<T1>& allocator1, const FrameAllocator<T2>& allocator2 )
+{
+    return allocator1.GetArena() == allocator2.GetArena();
+}
+
+template<typename T1, typename T2>
+bool operator!=( const FrameAllocator<T1>& allocator1, const FrameAllocator<T2>& allocator2 )
+{
+    return !(allocator1 == allocator2);
+}
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
\ No newline at end of file
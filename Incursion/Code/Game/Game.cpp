@@ -5,8 +5,11 @@
 #include "Game/AssetManagers/TextureManager.hpp"
 #include "Game/Entity/Entity.hpp"
 #include "Game/Entity/PlayerCharacter.hpp"
+#include "Game/FrameArena.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/Map/Map.hpp"
 #include "Game/Map/TileDefinition.hpp"
+#include "Game/ThreadPool.hpp"
 #include "Game/World.hpp"
 
 #include "Engine/Core/EngineCommon.hpp"
@@ -23,6 +26,7 @@
 #include "Engine/Renderer/Fonts/BitmapFont.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 #include "Engine/Renderer/Mesh/MeshUtils.hpp"
+#include "Engine/Renderer/Sprite/SpriteAnimDefinition.hpp"
 
 
 #include <winuser.rh>
@@ -31,6 +35,8 @@ bool g_DebugMode = false;
 bool g_FullMapView = false;
 bool g_NoClip = false;
 bool g_NoFog = false;
+bool g_PerTileRaycastFog = false;
+bool g_ParallelCollisions = false;
 
 BitmapFont* g_FontDefault = nullptr;
 
@@ -67,6 +73,12 @@ void Game::Shutdown()
     delete m_CurrentWorld;
     m_CurrentWorld = nullptr;
 
+    delete m_ExplosionAnimDef;
+    m_ExplosionAnimDef = nullptr;
+
+    delete m_ExplosionShader;
+    m_ExplosionShader = nullptr;
+
     delete m_GameCamera;
     m_GameCamera = nullptr;
 
@@ -75,6 +87,9 @@ void Game::Shutdown()
 
     delete m_Rng;
     m_Rng = nullptr;
+
+    delete m_ThreadPool;
+    m_ThreadPool = nullptr;
 }
 
 void Game::PlayerDied()
@@ -109,6 +124,11 @@ RandomNumberGenerator* Game::GetRng()
     return m_Rng;
 }
 
+ThreadPool* Game::GetThreadPool()
+{
+    return m_ThreadPool;
+}
+
 //-----------------------------------------------------------------------------
 void Game::Update( float deltaSeconds )
 {
@@ -198,6 +218,44 @@ void Game::HandleUserInputStateExclusive()
     {
         g_NoFog = !g_NoFog;
     }
+    if ( g_InputSystem->WasKeyJustPressed( F7 ) )
+    {
+        g_PerTileRaycastFog = !g_PerTileRaycastFog;
+    }
+    if ( g_InputSystem->WasKeyJustPressed( F2 ) )
+    {
+        Map* currentMap = m_CurrentWorld->GetCurrentMap();
+        int nextBroadphase = (static_cast<int>(currentMap->GetCollisionBroadphase()) + 1) %
+                             static_cast<int>(CollisionBroadphase::NUM_COLLISION_BROADPHASES);
+        currentMap->SetCollisionBroadphase( static_cast<CollisionBroadphase>(nextBroadphase) );
+    }
+    if ( g_InputSystem->WasKeyJustPressed( F11 ) )
+    {
+        g_ParallelCollisions = !g_ParallelCollisions;
+    }
+    if ( g_DebugMode && g_InputSystem->WasKeyJustPressed( 'C' ) )
+    {
+        Map* currentMap = m_CurrentWorld->GetCurrentMap();
+        int nextMode = (static_cast<int>(currentMap->GetContactSolverMode()) + 1) %
+                       static_cast<int>(ContactSolverMode::NUM_CONTACT_SOLVER_MODES);
+        currentMap->SetContactSolverMode( static_cast<ContactSolverMode>(nextMode) );
+    }
+    if ( g_DebugMode && g_InputSystem->WasKeyJustPressed( F5 ) )
+    {
+        m_CurrentWorld->GetCurrentMap()->SpawnCollisionStressEntities( 200, 2000 );
+    }
+    if ( g_DebugMode && g_InputSystem->WasKeyJustPressed( F9 ) )
+    {
+        m_CurrentWorld->GetCurrentMap()->BenchmarkRayCasts( 100000 );
+    }
+    if ( g_DebugMode && g_InputSystem->WasKeyJustPressed( F10 ) )
+    {
+        m_CurrentWorld->GetCurrentMap()->BenchmarkBroadphases( 10 );
+    }
+    if ( g_DebugMode && g_InputSystem->WasKeyJustPressed( F8 ) )
+    {
+        m_CurrentWorld->GetCurrentMap()->BenchmarkTileCollisions( 100000 );
+    }
 
     if ( g_InputSystem->IsKeyPressed( 'T' ) && !g_InputSystem->IsKeyPressed( 'Y' ) )
     {
@@ -238,6 +296,7 @@ void Game::UpdateCameraToPlayerPosition()
         AABB2 fullViewOrtho = AABB2( Vec2( 0.f, 0.f ), fullMapCoords );
         m_GameCamera->SetProjectionOrthographic( fullViewOrtho );
         m_GameCamera->SetCameraPosition( Vec3::ZERO );
+        m_GameCameraViewBounds = fullViewOrtho;
     }
     else
     {
@@ -253,13 +312,18 @@ void Game::UpdateCameraToPlayerPosition()
         m_GameCamera->SetCameraPosition( static_cast<Vec3>(playerPos - normalViewOrtho.GetPointAtUV( Vec2::ALIGN_CENTERED ) ) );
         m_GameCamera->FitCameraInAABB2( AABB2( Vec2( 0.f, 0.f ),
                                                static_cast<Vec2>(mapSize) ) );
+
+        // Read back from the fitted camera so the map culls exactly what is on screen
+        Vec2 cameraPosition = static_cast<Vec2>(m_GameCamera->GetPosition());
+        m_GameCameraViewBounds = AABB2( cameraPosition + normalViewOrtho.mins,
+                                        cameraPosition + normalViewOrtho.maxes );
     }
 }
 
 
 void Game::RenderLives() const
 {
-    std::vector<VertexMaster> liveVisual;
+    std::vector<VertexMaster>& liveVisual = g_FrameArena->AllocateVertexList();
     Vec2 liveStartingPoint = Vec2( 7.5f, MAX_UI_HEIGHT - 7.5f );
     Vec2 liveOffset = Vec2( 10.f, 0.f );
     for ( int liveIndex = 0; liveIndex < m_PlayerLives; liveIndex++ )
@@ -284,6 +348,10 @@ void Game::InitializeGameSystems()
     // Initialize Game Systems
     m_Rng = new RandomNumberGenerator();
 
+    // The main thread works alongside the pool's workers
+    int numWorkerThreads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+    m_ThreadPool = new ThreadPool( numWorkerThreads > 0 ? numWorkerThreads : 0 );
+
     m_GameCamera = new Camera(g_Renderer);
     m_GameCamera->SetProjectionOrthographic( AABB2( Vec2( 0.f, 0.f ),
                                        Vec2( m_NumVerticalTilesInView * CLIENT_ASPECT,
@@ -332,6 +400,18 @@ void Game::InitializeGameAssets()
     // Load Sprite Sheets
     g_Renderer->CreateOrGetSpriteSheetFromFile( SPRITE_SHEET_EXTRAS, IntVec2( 4, 4 ) );
 
+    // Explosion animation and shader, every pooled explosion points at these
+    m_ExplosionAnimDef = new SpriteAnimDefinition( *g_Renderer->CreateOrGetSpriteSheetFromFile( "Data/Sprites/Explosion5x5.png",
+                                                                                                IntVec2( 5, 5 ) ),
+                                                   0,
+                                                   24,
+                                                   EXPLOSION_ANIM_SECONDS,
+                                                   SpriteAnimPlaybackType::ONCE );
+    m_ExplosionShader = new Shader( g_Renderer->CreateOrGetShaderProgramFromFile( "DEFAULT" ) );
+    m_ExplosionShader->depthCompare = DepthCompare::ALWAYS;
+    m_ExplosionShader->writeDepth = false;
+    m_ExplosionShader->blendMode = BlendMode::ADDITIVE;
+
     // Initialize World
     m_CurrentWorld = new World( this );
     m_CurrentWorld->Create();
@@ -535,7 +615,7 @@ void Game::RenderPlay() const
     // Render Game
     g_Renderer->BeginCamera( *m_GameCamera );
 
-    m_CurrentWorld->Render();
+    m_CurrentWorld->Render( m_GameCameraViewBounds );
 
     if ( g_DebugMode )
     {
@@ -548,7 +628,40 @@ void Game::RenderPlay() const
     g_Renderer->BeginCamera( *m_UICamera );
     RenderLives();
 
-    std::vector<VertexMaster> overlay;
+    if ( g_DebugMode )
+    {
+        const Map* currentMap = m_CurrentWorld->GetCurrentMap();
+        const ContactCache& contactCache = currentMap->GetContactCache();
+        std::string debugStats = Stringf( "LOS cache hits: %i misses: %i\nDrawn tiles: %i culled entities: %i\nCollisions (%s%s): %.2fms\nContacts: %i begin: %i end: %i\nSolver (%s): %i iterations, %.4f overlap\nFrame arena: %.1fKB high water: %.1fKB overflows: %i vertex lists: %i\nMap arena: %.1fKB of %.1fKB in %i chunks",
+                                          currentMap->GetLineOfSightCacheHits(),
+                                          currentMap->GetLineOfSightCacheMisses(),
+                                          currentMap->GetNumTilesDrawn(),
+                                          currentMap->GetNumEntitiesCulled(),
+                                          GetCollisionBroadphaseName( currentMap->GetCollisionBroadphase() ),
+                                          g_ParallelCollisions ? ", islands" : "",
+                                          currentMap->GetCollisionSeconds() * 1000.0,
+                                          contactCache.GetNumContacts(),
+                                          contactCache.GetNumEventsOfType( ContactEventType::BEGIN ),
+                                          contactCache.GetNumEventsOfType( ContactEventType::END ),
+                                          GetContactSolverModeName( currentMap->GetContactSolverMode() ),
+                                          currentMap->GetContactSolver().GetNumIterationsUsed(),
+                                          currentMap->GetContactSolver().GetMaxOverlap(),
+                                          g_FrameArena->GetLastFrameBytesUsed() / 1024.f,
+                                          g_FrameArena->GetHighWaterBytes() / 1024.f,
+                                          g_FrameArena->GetLastFrameOverflowAllocations(),
+                                          g_FrameArena->GetVertexListHighWater(),
+                                          currentMap->GetArena().GetBytesUsed() / 1024.f,
+                                          currentMap->GetArena().GetBytesReserved() / 1024.f,
+                                          currentMap->GetArena().GetNumChunks() );
+        g_FontDefault->Render( *g_Renderer,
+                               debugStats,
+                               Vec2( MAX_UI_WIDTH * .02f, MAX_UI_HEIGHT * .05f ),
+                               2.f,
+                               Rgba8::WHITE,
+                               .6f );
+    }
+
+    std::vector<VertexMaster>& overlay = g_FrameArena->AllocateVertexList();
     AABB2 overlaySize = AABB2( Vec2::ZERO, Vec2( MAX_UI_WIDTH, MAX_UI_HEIGHT ) );
     Rgba8 transitionColor = Rgba8( 0, 0, 0, static_cast<unsigned char>(100 * m_DieTransition) );
 
@@ -610,7 +723,7 @@ void Game::RenderPause() const
     // Render Game
     g_Renderer->BeginCamera( *m_GameCamera );
 
-    m_CurrentWorld->Render();
+    m_CurrentWorld->Render( m_GameCameraViewBounds );
 
     if ( g_DebugMode )
     {
@@ -622,7 +735,7 @@ void Game::RenderPause() const
     // Render UI
     g_Renderer->BeginCamera( *m_UICamera );
 
-    std::vector<VertexMaster> overlay;
+    std::vector<VertexMaster>& overlay = g_FrameArena->AllocateVertexList();
     AABB2 overlaySize = AABB2( Vec2::ZERO, Vec2( MAX_UI_WIDTH, MAX_UI_HEIGHT ) );
     AppendAABB2( overlay, overlaySize, Rgba8::DARK_GRAY_75 );
     g_Renderer->BindTexture( nullptr );
@@ -647,14 +760,14 @@ void Game::RenderWin() const
     // Render Game
     g_Renderer->BeginCamera( *m_GameCamera );
 
-    m_CurrentWorld->Render();
+    m_CurrentWorld->Render( m_GameCameraViewBounds );
 
     g_Renderer->EndCamera( *m_GameCamera );
 
     // Render UI
     g_Renderer->BeginCamera( *m_UICamera );
 
-    std::vector<VertexMaster> overlay;
+    std::vector<VertexMaster>& overlay = g_FrameArena->AllocateVertexList();
     AABB2 overlaySize = AABB2( Vec2::ZERO, Vec2( MAX_UI_WIDTH, MAX_UI_HEIGHT ) );
     Rgba8 transitionColor = Rgba8( 0, 0, 0, static_cast<unsigned char>(255 * m_WinTransition) );
     AppendAABB2( overlay, overlaySize, transitionColor );
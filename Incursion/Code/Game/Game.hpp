@@ -2,19 +2,25 @@
 
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Math/Primatives/AABB2.hpp"
+#include "Engine/Renderer/Shaders/Shader.hpp"
 
 class Camera;
+class SpriteAnimDefinition;
 struct Vec3;
 
 #include "Game/GameCommon.hpp"
 
 class World;
 class PlayerCharacter;
+class ThreadPool;
 
 extern bool g_DebugMode;
 extern bool g_FullMapView;
 extern bool g_NoClip;
 extern bool g_NoFog;
+extern bool g_PerTileRaycastFog;
+extern bool g_ParallelCollisions;
 
 enum class GameState
 {
@@ -45,14 +51,23 @@ public:
     World* GetCurrentWorld() { return m_CurrentWorld; }
 
     RandomNumberGenerator* GetRng();
+    ThreadPool* GetThreadPool();
+    // Shared by every explosion
+    SpriteAnimDefinition* GetExplosionAnimDefinition() const    { return m_ExplosionAnimDef; }
+    Shader* GetExplosionShader() const                          { return m_ExplosionShader; }
 
 private:
     Camera* m_GameCamera = nullptr;
     float m_NumVerticalTilesInView = 9.f;
+    AABB2 m_GameCameraViewBounds = AABB2( Vec2( 0.f, 0.f ), Vec2( 0.f, 0.f ) );
 
     Camera* m_UICamera = nullptr;
 
     RandomNumberGenerator* m_Rng = nullptr;
+    ThreadPool* m_ThreadPool = nullptr;
+
+    SpriteAnimDefinition* m_ExplosionAnimDef = nullptr;
+    Shader* m_ExplosionShader = nullptr;
 
     World* m_CurrentWorld = nullptr;
 
@@ -7,6 +7,7 @@ class InputSystem;
 class RenderContext;
 class BitmapFont;
 class RandomNumberGenerator;
+class FrameArena;
 
 struct Vec2;
 struct Rgba8;
@@ -22,6 +23,10 @@ extern Window* g_Window;
 // Global advertisement for fonts
 extern BitmapFont* g_FontDefault;
 
+//-----------------------------------------------------------------------------
+// Global advertisement for per frame memory, reset by the App every frame
+extern FrameArena* g_FrameArena;
+
 //-----------------------------------------------------------------------------
 // Constants for the Game
 constexpr float CLIENT_ASPECT = 1.777f;                    // We are requesting a 1:1 aspect (square) window area
@@ -31,6 +36,7 @@ constexpr float MAX_UI_WIDTH = MAX_UI_HEIGHT * CLIENT_ASPECT;
 constexpr float MAX_SCREEN_SHAKE = 10.f;
 constexpr float SCREEN_SHAKE_ABLATION_PER_SECOND = 1.f;
 constexpr float CONTROLLER_VIBRATION_ABLATION_PER_SECOND = .5f;
+constexpr int FRAME_ARENA_BYTES = 256 * 1024;
 
 //-----------------------------------------------------------------------------
 // Game Rules
@@ -77,6 +83,10 @@ constexpr float TURRET_NPC_ENGAGE_APETURE = 5.f;
 // Bullet Rules
 constexpr float BULLET_MAX_VELOCITY = 6.f;
 
+//-----------------------------------------------------------------------------
+// Explosion Rules
+constexpr float EXPLOSION_ANIM_SECONDS = 1.f;               // Each explosion scales the animation to its duration
+
 //-------------------------------------------------------------------------------
 // Debris Rules
 constexpr float MAX_DEBRIS_LIFESPAN = 2.f;
@@ -87,6 +97,20 @@ constexpr float DEBRIS_MAX_SPEED = 55.f;
 //-----------------------------------------------------------------------------
 // Map Rules
 constexpr int NUM_MAPS = 3;
+constexpr bool MAP_BAKE_PVS = true;
+constexpr int MAP_PVS_RADIUS = static_cast<int>(TURRET_NPC_VIEW_DISTANCE * 1.415f) + 2;   // Taxicab reach of the longest view distance from anywhere in a tile
+constexpr int MAP_LINE_OF_SIGHT_CACHE_STEPS_PER_TILE = 16;  // Line of sight cache positions are snapped to this grid
+constexpr float MAP_WALL_DISTANCE_MAX = 4.f;
+constexpr int MAP_RENDER_CHUNK_SIZE = 16;
+constexpr int MAP_PARALLEL_COLLISION_MIN_PAIRS = 64;     // Fewer push pairs than this resolve on the calling thread
+constexpr float MAP_CONTACT_COINCIDENT_DIST = .001f;    // Closer discs are pushed apart along last frame's contact normal
+constexpr int MAP_CONTACT_SOLVER_ITERATIONS = 8;         // Most passes over the push contacts per frame
+constexpr float MAP_CONTACT_SOLVER_TOLERANCE = .001f;   // Solver stops once no contact overlaps by more than this
+constexpr int MAP_BULLET_POOL_SIZE = 512;               // Bullets constructed up front per map
+constexpr int MAP_EXPLOSION_POOL_SIZE = 512;            // Every bullet death spawns one
+constexpr int MAP_DEBRIS_POOL_SIZE = 256;
+constexpr int MAP_ARENA_CHUNK_BYTES = 64 * 1024;        // Tiles and long lived entities
+constexpr int MAP_GENERATION_ARENA_CHUNK_BYTES = 16 * 1024;
 
 extern Rgba8 DEBUG_FORWARD_VECTOR_COLOR;
 extern Rgba8 DEBUG_POSITOIN_VECTOR_COLOR;
@@ -0,0 +1,122 @@
+#include "CollisionIslands.hpp"
+
+#include "Game/FrameArena.hpp"
+
+//-----------------------------------------------------------------------------
+void CollisionIslands::Build( const EntityList* entityLists,
+                              int numLists,
+                              const std::vector<EntityGridPair>& pairs )
+{
+    m_ListSlotStarts.resize( numLists + 1 );
+    m_ListSlotStarts[ 0 ] = 0;
+    for( int listIndex = 0; listIndex < numLists; ++listIndex )
+    {
+        m_ListSlotStarts[ listIndex + 1 ] = m_ListSlotStarts[ listIndex ] + static_cast<int>(entityLists[ listIndex ].data.size());
+    }
+
+    int numSlots = m_ListSlotStarts[ numLists ];
+    m_Parents.resize( numSlots );
+    for( int slot = 0; slot < numSlots; ++slot )
+    {
+        m_Parents[ slot ] = slot;
+    }
+
+    // A pair touching a fixed entity belongs to the island of the other one
+    int numPairs = static_cast<int>(pairs.size());
+    for( int pairIndex = 0; pairIndex < numPairs; ++pairIndex )
+    {
+        const EntityGridPair& pair = pairs[ pairIndex ];
+        const Entity* entity1 = entityLists[ pair.first.listIndex ].data[ pair.first.entityIndex ];
+        const Entity* entity2 = entityLists[ pair.second.listIndex ].data[ pair.second.entityIndex ];
+        if( entity1->IsFixed() || entity2->IsFixed() ) { continue; }
+
+        Unite( GetSlot( pair.first ), GetSlot( pair.second ) );
+    }
+
+    // Islands are numbered by their first pair, then pairs are bucketed
+    m_RootIslands.assign( numSlots, -1 );
+    m_PairIslands.resize( numPairs );
+    m_SlotIslands.assign( numSlots, -1 );
+    m_IslandStarts.assign( 1, 0 );
+    for( int pairIndex = 0; pairIndex < numPairs; ++pairIndex )
+    {
+        const EntityGridPair& pair = pairs[ pairIndex ];
+        const Entity* entity1 = entityLists[ pair.first.listIndex ].data[ pair.first.entityIndex ];
+        const Entity* entity2 = entityLists[ pair.second.listIndex ].data[ pair.second.entityIndex ];
+        int slot = entity1->IsFixed() ? GetSlot( pair.second ) : GetSlot( pair.first );
+        int root = FindRoot( slot );
+        if( m_RootIslands[ root ] < 0 )
+        {
+            m_RootIslands[ root ] = static_cast<int>(m_IslandStarts.size()) - 1;
+            m_IslandStarts.push_back( 0 );
+        }
+
+        int islandIndex = m_RootIslands[ root ];
+        m_PairIslands[ pairIndex ] = islandIndex;
+        if( !entity1->IsFixed() ) { m_SlotIslands[ GetSlot( pair.first ) ] = islandIndex; }
+        if( !entity2->IsFixed() ) { m_SlotIslands[ GetSlot( pair.second ) ] = islandIndex; }
+        ++m_IslandStarts[ islandIndex + 1 ];
+    }
+
+    int numIslands = static_cast<int>(m_IslandStarts.size()) - 1;
+    for( int islandIndex = 0; islandIndex < numIslands; ++islandIndex )
+    {
+        m_IslandStarts[ islandIndex + 1 ] += m_IslandStarts[ islandIndex ];
+    }
+
+    FrameVector<int> islandFill( m_IslandStarts.begin(), m_IslandStarts.end() - 1, g_FrameArena->GetAllocator<int>() );
+    m_IslandPairIndices.resize( numPairs );
+    for( int pairIndex = 0; pairIndex < numPairs; ++pairIndex )
+    {
+        m_IslandPairIndices[ islandFill[ m_PairIslands[ pairIndex ] ]++ ] = pairIndex;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int CollisionIslands::GetNumIslandPairs( int islandIndex ) const
+{
+    return m_IslandStarts[ islandIndex + 1 ] - m_IslandStarts[ islandIndex ];
+}
+
+const int* CollisionIslands::GetIslandPairIndices( int islandIndex ) const
+{
+    return m_IslandPairIndices.data() + m_IslandStarts[ islandIndex ];
+}
+
+int CollisionIslands::GetEntityIsland( const EntityGridEntry& entry ) const
+{
+    return m_SlotIslands[ GetSlot( entry ) ];
+}
+
+//-----------------------------------------------------------------------------
+int CollisionIslands::GetSlot( const EntityGridEntry& entry ) const
+{
+    return m_ListSlotStarts[ entry.listIndex ] + entry.entityIndex;
+}
+
+int CollisionIslands::FindRoot( int slot )
+{
+    while( m_Parents[ slot ] != slot )
+    {
+        m_Parents[ slot ] = m_Parents[ m_Parents[ slot ] ];
+        slot = m_Parents[ slot ];
+    }
+    return slot;
+}
+
+// The lower slot stays root so the result doesn't depend on pair order
+void CollisionIslands::Unite( int slot1, int slot2 )
+{
+    int root1 = FindRoot( slot1 );
+    int root2 = FindRoot( slot2 );
+    if( root1 == root2 ) { return; }
+
+    if( root1 < root2 )
+    {
+        m_Parents[ root2 ] = root1;
+    }
+    else
+    {
+        m_Parents[ root1 ] = root2;
+    }
+}
\ No newline at end of file
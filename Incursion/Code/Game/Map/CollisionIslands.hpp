@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "Game/Entity/Entity.hpp"
+#include "Game/Map/EntityGrid.hpp"
+
+//-----------------------------------------------------------------------------
+// Groups push pairs into islands of entities that can move each other. Fixed
+// entities are never moved, so they don't join islands together. Every
+// entity that can move belongs to exactly one island, and resolving an
+// island only writes its own entities, so islands can resolve on different
+// threads. Islands and the pairs inside them keep the order of the pair
+// list, so the result is the same however islands are spread across threads.
+class CollisionIslands
+{
+public:
+    void Build( const EntityList* entityLists,
+                int numLists,
+                const std::vector<EntityGridPair>& pairs );
+
+    int GetNumIslands() const           { return static_cast<int>(m_IslandStarts.size()) - 1; }
+    int GetNumIslandPairs( int islandIndex ) const;
+    // Indices into the pair list Build was given
+    const int* GetIslandPairIndices( int islandIndex ) const;
+    // -1 for fixed entities and entities in no pair
+    int GetEntityIsland( const EntityGridEntry& entry ) const;
+
+private:
+    std::vector<int> m_ListSlotStarts;
+    std::vector<int> m_Parents;             // Union find over list slots
+    std::vector<int> m_RootIslands;         // Island index per root slot
+    std::vector<int> m_PairIslands;
+    std::vector<int> m_SlotIslands;
+    std::vector<int> m_IslandStarts;
+    std::vector<int> m_IslandPairIndices;
+
+    int GetSlot( const EntityGridEntry& entry ) const;
+    int FindRoot( int slot );
+    void Unite( int slot1, int slot2 );
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "ContactCache.hpp"
+
+#include <functional>
+
+#include "Game/Entity/Entity.hpp"
+
+//-----------------------------------------------------------------------------
+bool ContactCache::ContactKey::operator==( const ContactKey& other ) const
+{
+    return entity1 == other.entity1 && entity2 == other.entity2;
+}
+
+std::size_t ContactCache::ContactKeyHash::operator()( const ContactKey& key ) const
+{
+    std::size_t hash1 = std::hash<const Entity*>()( key.entity1 );
+    std::size_t hash2 = std::hash<const Entity*>()( key.entity2 );
+    return hash1 ^ (hash2 + 0x9e3779b9 + (hash1 << 6) + (hash1 >> 2));
+}
+
+//-----------------------------------------------------------------------------
+// Pairs are stored in address order so either argument order finds them
+ContactCache::ContactKey ContactCache::MakeKey( const Entity* entity1, const Entity* entity2 )
+{
+    ContactKey key;
+    key.entity1 = entity1 < entity2 ? entity1 : entity2;
+    key.entity2 = entity1 < entity2 ? entity2 : entity1;
+    return key;
+}
+
+//-----------------------------------------------------------------------------
+void ContactCache::BeginFrame()
+{
+    ++m_Frame;
+    m_Events.clear();
+}
+
+//-----------------------------------------------------------------------------
+// Recording a pair twice in a frame keeps the first event
+ContactEventType ContactCache::RecordContact( Entity* entity1, Entity* entity2, const Vec2& normal, float depth )
+{
+    ContactKey key = MakeKey( entity1, entity2 );
+    bool isSwapped = key.entity1 != entity1;
+
+    std::unordered_map<ContactKey, Contact, ContactKeyHash>::iterator found = m_Contacts.find( key );
+    bool isNewContact = found == m_Contacts.end();
+    if( isNewContact )
+    {
+        found = m_Contacts.insert( std::make_pair( key, Contact() ) ).first;
+    }
+
+    Contact& contact = found->second;
+    contact.entity1 = isSwapped ? entity2 : entity1;
+    contact.entity2 = isSwapped ? entity1 : entity2;
+    contact.normal = isSwapped ? -normal : normal;
+    contact.depth = depth;
+    if( !isNewContact && contact.lastFrame == m_Frame ) { return contact.lastEvent; }
+
+    contact.lastEvent = isNewContact ? ContactEventType::BEGIN : ContactEventType::STAY;
+    contact.lastFrame = m_Frame;
+
+    ContactEvent event;
+    event.type = contact.lastEvent;
+    event.entity1 = contact.entity1;
+    event.entity2 = contact.entity2;
+    event.normal = contact.normal;
+    event.depth = contact.depth;
+    m_Events.push_back( event );
+    return contact.lastEvent;
+}
+
+//-----------------------------------------------------------------------------
+void ContactCache::EndFrame()
+{
+    std::unordered_map<ContactKey, Contact, ContactKeyHash>::iterator contactIter = m_Contacts.begin();
+    while( contactIter != m_Contacts.end() )
+    {
+        const Contact& contact = contactIter->second;
+        bool isEntityGone = contact.entity1->IsGarbage() || contact.entity1->IsDead() ||
+                            contact.entity2->IsGarbage() || contact.entity2->IsDead();
+        if( contact.lastFrame == m_Frame && !isEntityGone )
+        {
+            ++contactIter;
+            continue;
+        }
+
+        ContactEvent event;
+        event.type = ContactEventType::END;
+        event.entity1 = contact.entity1;
+        event.entity2 = contact.entity2;
+        event.normal = contact.normal;
+        event.depth = 0.f;
+        m_Events.push_back( event );
+
+        contactIter = m_Contacts.erase( contactIter );
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ContactCache::Clear()
+{
+    m_Contacts.clear();
+    m_Events.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool ContactCache::GetPreviousNormal( const Entity* entity1, const Entity* entity2, Vec2& out_normal ) const
+{
+    ContactKey key = MakeKey( entity1, entity2 );
+    std::unordered_map<ContactKey, Contact, ContactKeyHash>::const_iterator found = m_Contacts.find( key );
+    if( found == m_Contacts.end() ) { return false; }
+
+    const Contact& contact = found->second;
+    out_normal = contact.entity1 == entity1 ? contact.normal : -contact.normal;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+int ContactCache::GetNumEventsOfType( ContactEventType type ) const
+{
+    int numEvents = 0;
+    for( int eventIndex = 0; eventIndex < m_Events.size(); ++eventIndex )
+    {
+        if( m_Events[ eventIndex ].type == type ) { ++numEvents; }
+    }
+    return numEvents;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+
+class Entity;
+
+enum class ContactEventType
+{
+    BEGIN,
+    STAY,
+    END,
+};
+
+// A resolved overlap waiting to be recorded, normal from entity1 to entity2
+struct EntityContact
+{
+    Entity* entity1 = nullptr;
+    Entity* entity2 = nullptr;
+    Vec2 normal = Vec2::ZERO;
+    float depth = 0.f;
+};
+
+// Normal points from entity1 toward entity2
+struct ContactEvent
+{
+    ContactEventType type = ContactEventType::BEGIN;
+    Entity* entity1 = nullptr;
+    Entity* entity2 = nullptr;
+    Vec2 normal = Vec2::ZERO;
+    float depth = 0.f;
+};
+
+//-----------------------------------------------------------------------------
+// Entity vs entity contacts that carry over between frames. The collision
+// handlers record each overlap they resolve, and EndFrame ends every contact
+// that wasn't recorded again, so each frame has a begin, stay or end event
+// per touching pair. Contacts with dead or garbage entities are ended before
+// those entities are deleted, so the cache never holds a freed entity.
+class ContactCache
+{
+public:
+    void BeginFrame();
+    ContactEventType RecordContact( Entity* entity1, Entity* entity2, const Vec2& normal, float depth );
+    void EndFrame();
+    void Clear();
+
+    // Normal from the last frame the pair touched, for warm starting push out
+    bool GetPreviousNormal( const Entity* entity1, const Entity* entity2, Vec2& out_normal ) const;
+
+    const std::vector<ContactEvent>& GetEvents() const  { return m_Events; }
+    int GetNumContacts() const          { return static_cast<int>(m_Contacts.size()); }
+    int GetNumEventsOfType( ContactEventType type ) const;
+
+private:
+    struct ContactKey
+    {
+        const Entity* entity1 = nullptr;
+        const Entity* entity2 = nullptr;
+
+        bool operator==( const ContactKey& other ) const;
+    };
+    struct ContactKeyHash
+    {
+        std::size_t operator()( const ContactKey& key ) const;
+    };
+    struct Contact
+    {
+        Entity* entity1 = nullptr;
+        Entity* entity2 = nullptr;
+        Vec2 normal = Vec2::ZERO;
+        float depth = 0.f;
+        int lastFrame = 0;
+        ContactEventType lastEvent = ContactEventType::BEGIN;
+    };
+
+    std::unordered_map<ContactKey, Contact, ContactKeyHash> m_Contacts;
+    std::vector<ContactEvent> m_Events;
+    int m_Frame = 0;
+
+    static ContactKey MakeKey( const Entity* entity1, const Entity* entity2 );
+};
\ No newline at end of file
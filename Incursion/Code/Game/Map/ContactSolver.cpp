@@ -0,0 +1,175 @@
+#include "ContactSolver.hpp"
+
+#include <cmath>
+
+#include "Game/ThreadPool.hpp"
+
+// Contacts per thread pool job in a Jacobi iteration
+constexpr int JACOBI_CONTACTS_PER_JOB = 256;
+
+//-----------------------------------------------------------------------------
+const char* GetContactSolverModeName( ContactSolverMode mode )
+{
+    switch( mode )
+    {
+        case ContactSolverMode::PAIRWISE:       return "pairwise";
+        case ContactSolverMode::GAUSS_SEIDEL:   return "gauss-seidel";
+        case ContactSolverMode::JACOBI:         return "jacobi";
+        default:                                return "unknown";
+    }
+}
+
+//-----------------------------------------------------------------------------
+ContactSolver::ContactSolver( int maxIterations, float tolerance )
+    : m_MaxIterations( maxIterations )
+    , m_Tolerance( tolerance )
+{
+}
+
+void ContactSolver::Clear()
+{
+    m_Bodies.clear();
+    m_Contacts.clear();
+    m_NumIterationsUsed = 0;
+    m_MaxOverlap = 0.f;
+}
+
+int ContactSolver::AddBody( const Vec2& position, float radius, bool isFixed )
+{
+    Body body;
+    body.position = position;
+    body.radius = radius;
+    body.inverseMass = isFixed ? 0.f : 1.f;
+    m_Bodies.push_back( body );
+    return static_cast<int>(m_Bodies.size()) - 1;
+}
+
+void ContactSolver::AddContact( int bodyIndex1, int bodyIndex2, const Vec2& fallbackNormal )
+{
+    Contact contact;
+    contact.bodyIndex1 = bodyIndex1;
+    contact.bodyIndex2 = bodyIndex2;
+    contact.fallbackNormal = fallbackNormal;
+    m_Contacts.push_back( contact );
+}
+
+//-----------------------------------------------------------------------------
+// How far each body has to move to just touch, split by inverse mass
+void ContactSolver::ComputeCorrection( Contact& contact ) const
+{
+    const Body& body1 = m_Bodies[ contact.bodyIndex1 ];
+    const Body& body2 = m_Bodies[ contact.bodyIndex2 ];
+    contact.correction1 = Vec2::ZERO;
+    contact.correction2 = Vec2::ZERO;
+    contact.overlap = 0.f;
+
+    float totalInverseMass = body1.inverseMass + body2.inverseMass;
+    if( totalInverseMass == 0.f ) { return; }
+
+    Vec2 displacement = body2.position - body1.position;
+    float distance = displacement.GetLength();
+    float overlap = body1.radius + body2.radius - distance;
+    if( overlap <= 0.f ) { return; }
+
+    Vec2 normal = distance > 0.f ? displacement / distance : contact.fallbackNormal;
+    contact.overlap = overlap;
+    contact.correction1 = normal * (-overlap * body1.inverseMass / totalInverseMass);
+    contact.correction2 = normal * (overlap * body2.inverseMass / totalInverseMass);
+}
+
+//-----------------------------------------------------------------------------
+void ContactSolver::SolveGaussSeidel()
+{
+    m_NumIterationsUsed = 0;
+    m_MaxOverlap = 0.f;
+    for( int iteration = 0; iteration < m_MaxIterations; ++iteration )
+    {
+        ++m_NumIterationsUsed;
+        m_MaxOverlap = 0.f;
+        for( int contactIndex = 0; contactIndex < m_Contacts.size(); ++contactIndex )
+        {
+            Contact& contact = m_Contacts[ contactIndex ];
+            ComputeCorrection( contact );
+            if( contact.overlap > m_MaxOverlap ) { m_MaxOverlap = contact.overlap; }
+
+            m_Bodies[ contact.bodyIndex1 ].position += contact.correction1;
+            m_Bodies[ contact.bodyIndex2 ].position += contact.correction2;
+        }
+
+        if( m_MaxOverlap <= m_Tolerance ) { break; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Corrections are summed in contact order on this thread so the result
+// doesn't depend on how jobs were scheduled
+void ContactSolver::SolveJacobi( ThreadPool* threadPool )
+{
+    int numContacts = static_cast<int>(m_Contacts.size());
+    int numJobs = (numContacts + JACOBI_CONTACTS_PER_JOB - 1) / JACOBI_CONTACTS_PER_JOB;
+    m_BatchMaxOverlaps.assign( numJobs, 0.f );
+
+    auto computeBatch = [this, numContacts]( int jobIndex )
+    {
+        int firstContact = jobIndex * JACOBI_CONTACTS_PER_JOB;
+        int endContact = firstContact + JACOBI_CONTACTS_PER_JOB;
+        if( endContact > numContacts ) { endContact = numContacts; }
+
+        float batchMaxOverlap = 0.f;
+        for( int contactIndex = firstContact; contactIndex < endContact; ++contactIndex )
+        {
+            Contact& contact = m_Contacts[ contactIndex ];
+            ComputeCorrection( contact );
+            if( contact.overlap > batchMaxOverlap ) { batchMaxOverlap = contact.overlap; }
+        }
+        m_BatchMaxOverlaps[ jobIndex ] = batchMaxOverlap;
+    };
+
+    m_NumIterationsUsed = 0;
+    m_MaxOverlap = 0.f;
+    for( int iteration = 0; iteration < m_MaxIterations; ++iteration )
+    {
+        ++m_NumIterationsUsed;
+        if( threadPool != nullptr )
+        {
+            threadPool->ParallelFor( numJobs, computeBatch );
+        }
+        else
+        {
+            for( int jobIndex = 0; jobIndex < numJobs; ++jobIndex )
+            {
+                computeBatch( jobIndex );
+            }
+        }
+
+        m_MaxOverlap = 0.f;
+        for( int jobIndex = 0; jobIndex < numJobs; ++jobIndex )
+        {
+            if( m_BatchMaxOverlaps[ jobIndex ] > m_MaxOverlap ) { m_MaxOverlap = m_BatchMaxOverlaps[ jobIndex ]; }
+        }
+        if( m_MaxOverlap <= m_Tolerance ) { break; }
+
+        for( int contactIndex = 0; contactIndex < numContacts; ++contactIndex )
+        {
+            const Contact& contact = m_Contacts[ contactIndex ];
+            if( contact.overlap <= 0.f ) { continue; }
+
+            Body& body1 = m_Bodies[ contact.bodyIndex1 ];
+            Body& body2 = m_Bodies[ contact.bodyIndex2 ];
+            body1.correctionSum += contact.correction1;
+            body2.correctionSum += contact.correction2;
+            ++body1.numCorrections;
+            ++body2.numCorrections;
+        }
+
+        for( int bodyIndex = 0; bodyIndex < m_Bodies.size(); ++bodyIndex )
+        {
+            Body& body = m_Bodies[ bodyIndex ];
+            if( body.numCorrections == 0 ) { continue; }
+
+            body.position += body.correctionSum / static_cast<float>(body.numCorrections);
+            body.correctionSum = Vec2::ZERO;
+            body.numCorrections = 0;
+        }
+    }
+}
\ No newline at end of file
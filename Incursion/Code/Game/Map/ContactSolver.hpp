@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+
+class ThreadPool;
+
+enum class ContactSolverMode
+{
+    PAIRWISE,           // Each pair pushed apart once, in list order
+    GAUSS_SEIDEL,
+    JACOBI,
+
+    NUM_CONTACT_SOLVER_MODES
+};
+
+const char* GetContactSolverModeName( ContactSolverMode mode );
+
+//-----------------------------------------------------------------------------
+// Iterative position solver for disc contacts. Every contact is resolved a
+// number of times per frame so piles of discs settle in one frame instead of
+// spreading the leftover overlap across later frames.
+//
+// Gauss-Seidel moves the discs as it goes through the contacts. Jacobi works
+// out every contact's correction from the same positions, which lets it run
+// across a thread pool, then moves each disc by the average of its
+// corrections. Both give the same result for any number of threads.
+class ContactSolver
+{
+public:
+    ContactSolver( int maxIterations, float tolerance );
+
+    void Clear();
+    int AddBody( const Vec2& position, float radius, bool isFixed );
+    // fallbackNormal separates the discs if their centers are on top of each other
+    void AddContact( int bodyIndex1, int bodyIndex2, const Vec2& fallbackNormal );
+
+    void SolveGaussSeidel();
+    void SolveJacobi( ThreadPool* threadPool );
+
+    void SetMaxIterations( int maxIterations )  { m_MaxIterations = maxIterations; }
+    void SetTolerance( float tolerance )        { m_Tolerance = tolerance; }
+
+    int GetNumBodies() const                { return static_cast<int>(m_Bodies.size()); }
+    int GetNumContacts() const              { return static_cast<int>(m_Contacts.size()); }
+    const Vec2& GetBodyPosition( int bodyIndex ) const  { return m_Bodies[ bodyIndex ].position; }
+    int GetNumIterationsUsed() const        { return m_NumIterationsUsed; }
+    float GetMaxOverlap() const             { return m_MaxOverlap; }
+
+private:
+    struct Body
+    {
+        Vec2 position = Vec2::ZERO;
+        float radius = 0.f;
+        float inverseMass = 1.f;            // 0 for fixed bodies
+        Vec2 correctionSum = Vec2::ZERO;
+        int numCorrections = 0;
+    };
+    struct Contact
+    {
+        int bodyIndex1 = 0;
+        int bodyIndex2 = 0;
+        Vec2 fallbackNormal = Vec2( 1.f, 0.f );
+        Vec2 correction1 = Vec2::ZERO;
+        Vec2 correction2 = Vec2::ZERO;
+        float overlap = 0.f;
+    };
+
+    std::vector<Body> m_Bodies;
+    std::vector<Contact> m_Contacts;
+    std::vector<float> m_BatchMaxOverlaps;
+
+    int m_MaxIterations = 0;
+    float m_Tolerance = 0.f;
+    int m_NumIterationsUsed = 0;
+    float m_MaxOverlap = 0.f;
+
+    void ComputeCorrection( Contact& contact ) const;
+};
\ No newline at end of file
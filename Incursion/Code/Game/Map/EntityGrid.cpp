@@ -0,0 +1,121 @@
+#include "EntityGrid.hpp"
+
+#include <cmath>
+
+#include "Game/FrameArena.hpp"
+
+// Keeps the grid from exploding into tiny cells when only small discs exist
+constexpr float MIN_ENTITY_GRID_CELL_SIZE = .5f;
+
+//-----------------------------------------------------------------------------
+static bool IsEntityInGrid( const Entity* entity )
+{
+    if( entity->IsDead() || entity->IsGarbage() ) { return false; }
+    return entity->OverlapsEntities();
+}
+
+//-----------------------------------------------------------------------------
+void EntityGrid::Clear()
+{
+    m_NumCells = IntVec2::ZERO;
+    m_CellStarts.clear();
+    m_Entries.clear();
+}
+
+void EntityGrid::Rebuild( const EntityList* entityLists, int numLists, const IntVec2& mapSize )
+{
+    float maxRadius = 0.f;
+    int numEntries = 0;
+    for( int listIndex = 0; listIndex < numLists; ++listIndex )
+    {
+        const EntityList& entityList = entityLists[ listIndex ];
+        for( int entityIndex = 0; entityIndex < entityList.data.size(); ++entityIndex )
+        {
+            const Entity* entity = entityList.data[ entityIndex ];
+            if( !IsEntityInGrid( entity ) ) { continue; }
+
+            float radius = entity->GetPhysicsRadius();
+            if( radius > maxRadius ) { maxRadius = radius; }
+            ++numEntries;
+        }
+    }
+
+    m_CellSize = 2.f * maxRadius;
+    if( m_CellSize < MIN_ENTITY_GRID_CELL_SIZE ) { m_CellSize = MIN_ENTITY_GRID_CELL_SIZE; }
+    m_NumCells = IntVec2( static_cast<int>(ceilf( mapSize.x / m_CellSize )),
+                          static_cast<int>(ceilf( mapSize.y / m_CellSize )) );
+    if( m_NumCells.x < 1 ) { m_NumCells.x = 1; }
+    if( m_NumCells.y < 1 ) { m_NumCells.y = 1; }
+
+    // Count per cell, prefix sum into starts, then scatter
+    int numCells = m_NumCells.x * m_NumCells.y;
+    m_CellStarts.assign( numCells + 1, 0 );
+    for( int listIndex = 0; listIndex < numLists; ++listIndex )
+    {
+        const EntityList& entityList = entityLists[ listIndex ];
+        for( int entityIndex = 0; entityIndex < entityList.data.size(); ++entityIndex )
+        {
+            const Entity* entity = entityList.data[ entityIndex ];
+            if( !IsEntityInGrid( entity ) ) { continue; }
+
+            int cellIndex = GetCellIndex( GetCellCoords( static_cast<Vec2>(entity->GetPosition()) ) );
+            ++m_CellStarts[ cellIndex + 1 ];
+        }
+    }
+    for( int cellIndex = 0; cellIndex < numCells; ++cellIndex )
+    {
+        m_CellStarts[ cellIndex + 1 ] += m_CellStarts[ cellIndex ];
+    }
+
+    FrameVector<int> cellFill( m_CellStarts.begin(), m_CellStarts.end() - 1, g_FrameArena->GetAllocator<int>() );
+    m_Entries.resize( numEntries );
+    for( int listIndex = 0; listIndex < numLists; ++listIndex )
+    {
+        const EntityList& entityList = entityLists[ listIndex ];
+        for( int entityIndex = 0; entityIndex < entityList.data.size(); ++entityIndex )
+        {
+            const Entity* entity = entityList.data[ entityIndex ];
+            if( !IsEntityInGrid( entity ) ) { continue; }
+
+            int cellIndex = GetCellIndex( GetCellCoords( static_cast<Vec2>(entity->GetPosition()) ) );
+            EntityGridEntry& entry = m_Entries[ cellFill[ cellIndex ]++ ];
+            entry.listIndex = listIndex;
+            entry.entityIndex = entityIndex;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void EntityGrid::GetEntriesNear( const Vec2& position, std::vector<EntityGridEntry>& out_entries ) const
+{
+    GetEntriesNearBox( position, position, out_entries );
+}
+
+//-----------------------------------------------------------------------------
+void EntityGrid::GetEntriesNearBox( const Vec2& boxMins, const Vec2& boxMaxes, std::vector<EntityGridEntry>& out_entries ) const
+{
+    VisitEntriesNearBox( boxMins, boxMaxes, [&out_entries]( const EntityGridEntry& entry )
+    {
+        out_entries.push_back( entry );
+        return true;
+    } );
+}
+
+//-----------------------------------------------------------------------------
+// Positions off the map land in the border cells
+IntVec2 EntityGrid::GetCellCoords( const Vec2& position ) const
+{
+    IntVec2 cellCoords = IntVec2( static_cast<int>(floorf( position.x / m_CellSize )),
+                                  static_cast<int>(floorf( position.y / m_CellSize )) );
+    if( cellCoords.x < 0 ) { cellCoords.x = 0; }
+    if( cellCoords.y < 0 ) { cellCoords.y = 0; }
+    if( cellCoords.x >= m_NumCells.x ) { cellCoords.x = m_NumCells.x - 1; }
+    if( cellCoords.y >= m_NumCells.y ) { cellCoords.y = m_NumCells.y - 1; }
+    return cellCoords;
+}
+
+//-----------------------------------------------------------------------------
+int EntityGrid::GetCellIndex( const IntVec2& cellCoords ) const
+{
+    return cellCoords.y * m_NumCells.x + cellCoords.x;
+}
\ No newline at end of file
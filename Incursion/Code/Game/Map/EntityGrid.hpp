@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/IntVec2.hpp"
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+
+#include "Game/Entity/Entity.hpp"
+
+// Entities are referenced by list and slot so lookups survive lists growing
+struct EntityGridEntry
+{
+    EntityListIndex listIndex = 0;
+    int entityIndex = 0;
+};
+
+// Candidate pair from a broadphase, still needs the narrow phase test
+struct EntityGridPair
+{
+    EntityGridEntry first;
+    EntityGridEntry second;
+};
+
+//-----------------------------------------------------------------------------
+// Uniform grid over the map for the entity broadphase. Cells are as wide as
+// the largest physics disc, so any disc overlapping an entity's disc has its
+// center in the entity's cell or one of the 8 around it. Entries are stored
+// sorted by cell, rebuilt from scratch each frame.
+class EntityGrid
+{
+public:
+    void Rebuild( const EntityList* entityLists, int numLists, const IntVec2& mapSize );
+    void Clear();
+
+    float GetCellSize() const { return m_CellSize; }
+    void GetEntriesNear( const Vec2& position, std::vector<EntityGridEntry>& out_entries ) const;
+    // Entries near any point in the box, each entry reported once
+    void GetEntriesNearBox( const Vec2& boxMins, const Vec2& boxMaxes, std::vector<EntityGridEntry>& out_entries ) const;
+    // Calls visitor( entry ) for the same entries as GetEntriesNearBox without
+    // copying them out, stops early if the visitor returns false
+    template<typename ENTRY_VISITOR>
+    void VisitEntriesNearBox( const Vec2& boxMins, const Vec2& boxMaxes, ENTRY_VISITOR visitor ) const;
+
+private:
+    float m_CellSize = 1.f;
+    IntVec2 m_NumCells = IntVec2::ZERO;
+    std::vector<int> m_CellStarts;
+    std::vector<EntityGridEntry> m_Entries;
+
+    IntVec2 GetCellCoords( const Vec2& position ) const;
+    int GetCellIndex( const IntVec2& cellCoords ) const;
+};
+
+//-----------------------------------------------------------------------------
+template<typename ENTRY_VISITOR>
+void EntityGrid::VisitEntriesNearBox( const Vec2& boxMins, const Vec2& boxMaxes, ENTRY_VISITOR visitor ) const
+{
+    if( m_Entries.empty() ) { return; }
+
+    IntVec2 minCell = GetCellCoords( boxMins );
+    IntVec2 maxCell = GetCellCoords( boxMaxes );
+    for( int cellY = minCell.y - 1; cellY <= maxCell.y + 1; ++cellY )
+    {
+        if( cellY < 0 || cellY >= m_NumCells.y ) { continue; }
+        for( int cellX = minCell.x - 1; cellX <= maxCell.x + 1; ++cellX )
+        {
+            if( cellX < 0 || cellX >= m_NumCells.x ) { continue; }
+
+            int cellIndex = GetCellIndex( IntVec2( cellX, cellY ) );
+            for( int entryIndex = m_CellStarts[ cellIndex ]; entryIndex < m_CellStarts[ cellIndex + 1 ]; ++entryIndex )
+            {
+                if( !visitor( m_Entries[ entryIndex ] ) ) { return; }
+            }
+        }
+    }
+}
\ No newline at end of file
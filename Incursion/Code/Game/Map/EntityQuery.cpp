@@ -0,0 +1,30 @@
+#include "EntityQuery.hpp"
+
+//-----------------------------------------------------------------------------
+FactionMask GetHostileFactionMask( Faction faction )
+{
+    switch( faction )
+    {
+        case FACTION_PLAYER:    return GetFactionMask( FACTION_ENEMY );
+        case FACTION_ENEMY:     return GetFactionMask( FACTION_PLAYER );
+        default:                return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool EntityQueryFilter::Accepts( const Entity* entity ) const
+{
+    if( entity == nullptr || entity == ignoredEntity ) { return false; }
+    if( entity->IsDead() || entity->IsGarbage() ) { return false; }
+    if( (typeMask & GetEntityTypeMask( entity->GetEntityType() )) == 0 ) { return false; }
+    return (factionMask & GetFactionMask( entity->GetEntityFaction() )) != 0;
+}
+
+//-----------------------------------------------------------------------------
+EntityQueryFilter MakeHostileCombatantFilter( Faction faction )
+{
+    EntityQueryFilter filter;
+    filter.typeMask = COMBATANT_ENTITY_TYPES;
+    filter.factionMask = GetHostileFactionMask( faction );
+    return filter;
+}
\ No newline at end of file
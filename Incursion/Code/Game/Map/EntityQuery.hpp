@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Game/Entity/Entity.hpp"
+
+typedef uint32_t EntityTypeMask;
+typedef uint32_t FactionMask;
+
+constexpr EntityTypeMask ALL_ENTITY_TYPES = 0xffffffffu;
+constexpr FactionMask ALL_FACTIONS = 0xffffffffu;
+
+static_assert( NUM_ENTITY_TYPES <= 32, "EntityTypeMask needs a bit per entity type" );
+static_assert( NUM_FACTION_TYPES <= 32, "FactionMask needs a bit per faction" );
+
+constexpr EntityTypeMask GetEntityTypeMask( EntityType type )   { return 1u << type; }
+constexpr FactionMask GetFactionMask( Faction faction )         { return 1u << faction; }
+
+// Tanks, turrets and the player, the entities AI can aim at
+constexpr EntityTypeMask COMBATANT_ENTITY_TYPES = GetEntityTypeMask( ENTITY_ALLIED_TURRET ) |
+                                                  GetEntityTypeMask( ENTITY_ENEMY_TURRET ) |
+                                                  GetEntityTypeMask( ENTITY_ALLIED_TANK ) |
+                                                  GetEntityTypeMask( ENTITY_ENEMY_TANK ) |
+                                                  GetEntityTypeMask( ENTITY_PLAYER );
+
+// Factions that fight the given faction, neutral and nature fight nobody
+FactionMask GetHostileFactionMask( Faction faction );
+
+//-----------------------------------------------------------------------------
+// Which entities a Map spatial query reports. Dead and garbage entities are
+// never reported.
+struct EntityQueryFilter
+{
+    EntityTypeMask typeMask = ALL_ENTITY_TYPES;
+    FactionMask factionMask = ALL_FACTIONS;
+    const Entity* ignoredEntity = nullptr;
+
+    bool Accepts( const Entity* entity ) const;
+};
+
+// Combatants of factions hostile to the given one
+EntityQueryFilter MakeHostileCombatantFilter( Faction faction );
\ No newline at end of file
@@ -5,11 +5,13 @@
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/Utils/StringUtils.hpp"
 
+#include "Game/GameCommon.hpp"
 #include "Game/Map/TileDefinition.hpp"
 #include "Game/Map/Generation/DrunkenWorm.hpp"
 
 MapGeneration::MapGeneration()
     : m_MapRng()
+    , m_WormArena( MAP_GENERATION_ARENA_CHUNK_BYTES )
 {
 }
 
@@ -229,7 +231,7 @@ Worm* MapGeneration::CreateNewWorm( WormType wormType,
 {
     switch ( wormType )
     {
-        case WORM_DRUNKEN: return new DrunkenWorm( position, tile, size );
+        case WORM_DRUNKEN: return m_WormArena.New<DrunkenWorm>( position, tile, size );
         default:
             ERROR_AND_DIE( Stringf( "Cannot create worm of type %i", wormType ) );
     }
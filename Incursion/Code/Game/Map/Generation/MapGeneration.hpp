@@ -4,6 +4,7 @@
 
 #include "Engine/Core/Math/RandomNumberGenerator.hpp"
 
+#include "Game/Map/MapArena.hpp"
 #include "Game/Map/Tile.hpp"
 #include "Game/Map/Generation/Worm.hpp"
 
@@ -53,6 +54,8 @@ private:
     IntVec2 m_MapEnd = IntVec2::ZERO;
     int m_EndFortSize = 1;
 
+    // Worms are only needed while generating, they go with the generator
+    MapArena m_WormArena;
     WormList m_WormsByTileType[ NUM_TILE_TYPES ];
 
     //-------------------------------------------------------------------------
@@ -1,26 +1,38 @@
 #include "Map.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 #include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Time.hpp"
 #include "Engine/Core/Utils/VectorPcuUtils.hpp"
-#include "Engine/Core/STL/RapidReplaceVector.hpp"
 #include "Engine/Core/Math/RandomNumberGenerator.hpp"
 #include "Engine/Core/Math/Primatives/AABB2.hpp"
 #include "Engine/Renderer/RenderContext.hpp"
 #include "Engine/Renderer/Sprite/SpriteSheet.hpp"
 #include "Engine/Renderer/Sprite/SpriteDefinition.hpp"
 
+#include "Game/FrameArena.hpp"
 #include "Game/Game.hpp"
+#include "Game/ThreadPool.hpp"
 #include "Game/World.hpp"
 #include "Game/AssetManagers/TextureManager.hpp"
 #include "Game/Entity/Entity.hpp"
+#include "Game/Entity/EntityPhysics.hpp"
 #include "Game/Entity/PlayerCharacter.hpp"
 #include "Game/Entity/Bolder.hpp"
 #include "Game/Entity/Bullet.hpp"
+#include "Game/Entity/Debris.hpp"
 #include "Game/Entity/TankNPC.hpp"
 #include "Game/Entity/TurretNPC.hpp"
 #include "Game/Entity/Explosion.hpp"
+#include "Game/Map/Shadowcast.hpp"
+#include "Game/Map/SweptCollision.hpp"
 #include "Game/Map/Tile.hpp"
 #include "Game/Map/TileDefinition.hpp"
 #include "Game/Map/Generation/MapGeneration.hpp"
@@ -36,6 +48,9 @@ Map::Map( Game* gameInstance, World* world, int sizeX, int sizeY )
   , m_World( world )
   , m_Size( sizeX, sizeY )
   , m_NumTiles( sizeX * sizeY )
+  , m_Arena( MAP_ARENA_CHUNK_BYTES )
+  , m_Tiles( m_Arena.GetAllocator<Tile>() )
+  , m_ContactSolver( MAP_CONTACT_SOLVER_ITERATIONS, MAP_CONTACT_SOLVER_TOLERANCE )
 {
 }
 
@@ -44,12 +59,21 @@ Map::Map( Game* gameInstance, World* world, const IntVec2& size )
   , m_World( world )
   , m_Size( size )
   , m_NumTiles( m_Size.x * m_Size.y )
+  , m_Arena( MAP_ARENA_CHUNK_BYTES )
+  , m_Tiles( m_Arena.GetAllocator<Tile>() )
+  , m_ContactSolver( MAP_CONTACT_SOLVER_ITERATIONS, MAP_CONTACT_SOLVER_TOLERANCE )
 {
 }
 
 void Map::Create()
 {
     m_Tiles.reserve( m_NumTiles );
+    PrewarmEntityPools();
+
+    // Without a pool everything runs on the driving thread, which only needs
+    // its own queue. Collision and the contact solver fall back the same way.
+    ThreadPool* threadPool = m_GameInstance->GetThreadPool();
+    m_CommandBuffer.Resize( threadPool != nullptr ? threadPool->GetNumWorkers() : 0 );
 }
 
 //-----------------------------------------------------------------------------
@@ -60,39 +84,67 @@ void Map::GenerateMap( MapGeneration& generator )
 
     std::vector<TileType> tiles = generator.GenerateMap();
 
+    m_SolidTiles.Resize( m_Size );
+    m_RaycastBlockingTiles.Resize( m_Size );
+    m_ProjectileBlockingTiles.Resize( m_Size );
+    m_MudTiles.Resize( m_Size );
+
     for( int tileIndex = 0; tileIndex < tiles.size(); ++tileIndex )
     {
         IntVec2 tilePos = IntVec2( tileIndex % m_Size.x, tileIndex / m_Size.x );
         m_Tiles.push_back( Tile( tilePos, tiles.at( tileIndex ) ) );
+        UpdateTileBitmaps( m_Tiles.back() );
+    }
+    m_WallDistanceField.Build( m_SolidTiles, MAP_WALL_DISTANCE_MAX );
+    m_SolidNeighborMasks.Build( m_SolidTiles );
+    m_MudNeighborMasks.Build( m_MudTiles );
+    CreateTileRenderChunks();
+
+    if( MAP_BAKE_PVS )
+    {
+        m_PotentiallyVisibleSet.Bake( m_RaycastBlockingTiles, MAP_PVS_RADIUS );
     }
 }
 
 void Map::Update( float deltaSeconds )
 {
+    ClearLineOfSightCache();
+
+    // Entity queries made while entities update read this grid
+    m_EntityGrid.Rebuild( m_EntityListsByType, NUM_ENTITY_TYPES, m_Size );
     UpdateEntities( deltaSeconds );
+    // Shots fired this frame are in the lists before collisions run
+    ApplyCommands();
 
     UpdateFogOfWar( ENTITY_PLAYER, 8, 8, CLIENT_ASPECT );
 
+    double collisionStartTime = GetCurrentTimeSeconds();
+    m_ContactCache.BeginFrame();
     HandleMapCollisions();
+    HandleBulletContactEvents();
+    m_ContactCache.EndFrame();
+    m_CollisionSeconds = GetCurrentTimeSeconds() - collisionStartTime;
 
+    // Explosions from entities that died in collisions
+    ApplyCommands();
     DeleteGarbageEntities();
 }
 
-void Map::Render() const
+void Map::Render( const AABB2& viewBounds ) const
 {
-    RenderTiles();
-    RenderEntities();
+    RenderTiles( viewBounds );
+    RenderEntities( viewBounds );
 }
 
 void Map::DebugRender() const
 {
     DebugRenderEntities();
 
-    std::vector<VertexMaster> collisionVisual;
+    std::vector<VertexMaster>& collisionVisual = g_FrameArena->AllocateVertexList();
     for ( int tileIndex = 0; tileIndex < m_Tiles.size(); ++tileIndex )
     {
         const Tile& currentTile = m_Tiles.at( tileIndex );
-        if ( currentTile.IsSolid() )
+        if ( IsTileSolid( currentTile ) )
         {
             AppendAABB2( collisionVisual, currentTile.GetTileBoundingBox(), Rgba8::CYAN );
         }
@@ -105,6 +157,10 @@ void Map::DebugRender() const
 void Map::Destroy()
 {
     DestroyEntities();
+
+    // The tile storage goes with the arena
+    m_Tiles = MapArenaVector<Tile>( m_Arena.GetAllocator<Tile>() );
+    m_Arena.Release();
 }
 
 const IntVec2 Map::GetMapSize() const
@@ -114,22 +170,174 @@ const IntVec2 Map::GetMapSize() const
 
 bool Map::IsPointInSolid( const Vec2& point ) const
 {
-    bool isInSolidTile = IsTileSolid( *GetTileFromPosition( static_cast<IntVec2>(point) ) );
-    return isInSolidTile;
+    return IsTilePositionSolid( GetTilePositionFromWorldCoords( point ) );
 }
 
 bool Map::IsPointBlockRaycast( const Vec2& point ) const
 {
-    IntVec2 tilePos = GetTilePositionFromWorldCoords( point );
-    if( IsValidTilePos( tilePos ) )
+    return DoesTilePositionBlockRaycast( GetTilePositionFromWorldCoords( point ) );
+}
+
+float Map::GetWallDistance( const Vec2& point ) const
+{
+    return m_WallDistanceField.SampleDistance( point );
+}
+
+Vec2 Map::GetWallNormal( const Vec2& point ) const
+{
+    return m_WallDistanceField.SampleNormal( point );
+}
+
+//-----------------------------------------------------------------------------
+// The grid is rebuilt at the start of the frame. Its extra ring of cells is as
+// wide as the largest disc, which covers each disc's radius and the distance
+// it moved since.
+int Map::QueryEntitiesInDisc( const Vec2& center,
+                              float radius,
+                              const EntityQueryFilter& filter,
+                              Entity** out_entities,
+                              int maxEntities ) const
+{
+    if( maxEntities <= 0 ) { return 0; }
+
+    int numFound = 0;
+    const Disc queryDisc = Disc( center, radius );
+    Vec2 extents = Vec2( radius, radius );
+    m_EntityGrid.VisitEntriesNearBox( center - extents, center + extents, [&]( const EntityGridEntry& entry )
+    {
+        Entity* entity = GetGridEntryEntity( entry );
+        if( !filter.Accepts( entity ) ) { return true; }
+        if( !DoDiscsOverlap( queryDisc, entity->GetEntityPhysicsDisc() ) ) { return true; }
+
+        out_entities[ numFound++ ] = entity;
+        return numFound < maxEntities;
+    } );
+    return numFound;
+}
+
+int Map::QueryEntitiesInAABB( const AABB2& bounds,
+                              const EntityQueryFilter& filter,
+                              Entity** out_entities,
+                              int maxEntities ) const
+{
+    if( maxEntities <= 0 ) { return 0; }
+
+    int numFound = 0;
+    m_EntityGrid.VisitEntriesNearBox( bounds.mins, bounds.maxes, [&]( const EntityGridEntry& entry )
+    {
+        Entity* entity = GetGridEntryEntity( entry );
+        if( !filter.Accepts( entity ) ) { return true; }
+
+        Vec2 center = static_cast<Vec2>(entity->GetPosition());
+        Vec2 nearestPoint = Vec2( fmaxf( bounds.mins.x, fminf( center.x, bounds.maxes.x ) ),
+                                  fmaxf( bounds.mins.y, fminf( center.y, bounds.maxes.y ) ) );
+        float radius = entity->GetPhysicsRadius();
+        if( (nearestPoint - center).GetLengthSquared() >= radius * radius ) { return true; }
+
+        out_entities[ numFound++ ] = entity;
+        return numFound < maxEntities;
+    } );
+    return numFound;
+}
+
+int Map::QueryEntitiesInCone( const Vec2& origin,
+                              float facingDegrees,
+                              float apertureDegrees,
+                              float range,
+                              const EntityQueryFilter& filter,
+                              Entity** out_entities,
+                              int maxEntities ) const
+{
+    if( maxEntities <= 0 ) { return 0; }
+
+    int numFound = 0;
+    Vec2 forward = Vec2::MakeFromPolarDegrees( facingDegrees );
+    float cosHalfAperture = Vec2::MakeFromPolarDegrees( apertureDegrees * .5f ).x;
+    Vec2 extents = Vec2( range, range );
+    m_EntityGrid.VisitEntriesNearBox( origin - extents, origin + extents, [&]( const EntityGridEntry& entry )
+    {
+        Entity* entity = GetGridEntryEntity( entry );
+        if( !filter.Accepts( entity ) ) { return true; }
+
+        Vec2 displacement = static_cast<Vec2>(entity->GetPosition()) - origin;
+        float distance = displacement.GetLength();
+        if( distance - entity->GetPhysicsRadius() > range ) { return true; }
+        if( distance > 0.f && DotProduct2D( displacement, forward ) < distance * cosHalfAperture ) { return true; }
+
+        out_entities[ numFound++ ] = entity;
+        return numFound < maxEntities;
+    } );
+    return numFound;
+}
+
+//-----------------------------------------------------------------------------
+// Searches a growing box until the closest match so far is inside it, so
+// nearby targets only touch a few cells
+Entity* Map::FindNearestEntity( const Vec2& position, float maxDistance, const EntityQueryFilter& filter ) const
+{
+    Entity* nearestEntity = nullptr;
+    float nearestDistanceSquared = maxDistance * maxDistance;
+    float mapExtent = static_cast<float>(m_Size.x + m_Size.y);
+    float searchRadius = m_EntityGrid.GetCellSize();
+    while( true )
     {
-        bool isInBlockRaycast = DoseTileBlockRaycast( *GetTileFromPosition( tilePos ) );
-        return isInBlockRaycast;
+        if( searchRadius > maxDistance ) { searchRadius = maxDistance; }
+
+        Vec2 extents = Vec2( searchRadius, searchRadius );
+        m_EntityGrid.VisitEntriesNearBox( position - extents, position + extents, [&]( const EntityGridEntry& entry )
+        {
+            Entity* entity = GetGridEntryEntity( entry );
+            if( !filter.Accepts( entity ) ) { return true; }
+
+            float distanceSquared = (static_cast<Vec2>(entity->GetPosition()) - position).GetLengthSquared();
+            if( distanceSquared <= nearestDistanceSquared )
+            {
+                nearestEntity = entity;
+                nearestDistanceSquared = distanceSquared;
+            }
+            return true;
+        } );
+
+        if( nearestEntity != nullptr && nearestDistanceSquared <= searchRadius * searchRadius ) { break; }
+        if( searchRadius >= maxDistance || searchRadius >= mapExtent ) { break; }
+        searchRadius *= 2.f;
     }
-    else
+    return nearestEntity;
+}
+
+// Every entity in range is ranked, line of sight is only checked for ones
+// closer than the nearest visible entity so far
+Entity* Map::FindNearestVisibleEntity( const Entity& viewer, float maxDistance, const EntityQueryFilter& filter ) const
+{
+    Vec2 viewerPosition = static_cast<Vec2>(viewer.GetPosition());
+    const Disc queryDisc = Disc( viewerPosition, maxDistance );
+    Vec2 extents = Vec2( maxDistance, maxDistance );
+
+    Entity* nearestEntity = nullptr;
+    float nearestDistanceSquared = 0.f;
+    m_EntityGrid.VisitEntriesNearBox( viewerPosition - extents, viewerPosition + extents, [&]( const EntityGridEntry& entry )
     {
+        Entity* entity = GetGridEntryEntity( entry );
+        if( !filter.Accepts( entity ) ) { return true; }
+        if( !DoDiscsOverlap( queryDisc, entity->GetEntityPhysicsDisc() ) ) { return true; }
+
+        float distanceSquared = (static_cast<Vec2>(entity->GetPosition()) - viewerPosition).GetLengthSquared();
+        if( nearestEntity != nullptr && distanceSquared >= nearestDistanceSquared ) { return true; }
+        if( !HasLineOfSight( viewer, *entity, maxDistance ) ) { return true; }
+
+        nearestEntity = entity;
+        nearestDistanceSquared = distanceSquared;
         return true;
-    }
+    } );
+    return nearestEntity;
+}
+
+// Slots can empty or be reused after the grid was built
+Entity* Map::GetGridEntryEntity( const EntityGridEntry& entry ) const
+{
+    const EntityList& entityList = m_EntityListsByType[ entry.listIndex ];
+    if( entry.entityIndex >= entityList.data.size() ) { return nullptr; }
+    return entityList.data[ entry.entityIndex ];
 }
 
 Entity* Map::SpawnNewEntityAtStart( EntityType type )
@@ -147,17 +355,35 @@ Entity* Map::SpawnNewEntity( EntityType type, const Vec2& spawnPosition )
 
 Explosion* Map::SpawnNewExplosion( const Vec3& position, float duration, const Vec3& scale )
 {
-    Explosion* spanwedEntity = new Explosion( m_GameInstance,
-                                              this,
-                                              position,
-                                              duration,
-                                              scale
-                                            );
+    Explosion* spanwedEntity = m_ExplosionPool.Acquire();
+    if( spanwedEntity != nullptr )
+    {
+        spanwedEntity->Reuse( position, duration, scale );
+    }
+    else
+    {
+        spanwedEntity = new Explosion( m_GameInstance,
+                                       this,
+                                       position,
+                                       duration,
+                                       scale
+                                     );
+    }
     spanwedEntity->Create();
     AddEntityToMap( ENTITY_EXPLOSION, spanwedEntity );
     return spanwedEntity;
 }
 
+void Map::RequestSpawnBullet( EntityType type, const Vec3& position, const Vec2& direction )
+{
+    m_CommandBuffer.RecordSpawnBullet( type, position, direction );
+}
+
+void Map::RequestSpawnExplosion( const Vec3& position, float duration, const Vec3& scale )
+{
+    m_CommandBuffer.RecordSpawnExplosion( position, duration, scale );
+}
+
 void Map::SpawnNewEntitiesOfTypeInOpenSpace( int number, EntityType type )
 {
     for( int entityIndex = 0; entityIndex < number; ++entityIndex )
@@ -167,6 +393,21 @@ void Map::SpawnNewEntitiesOfTypeInOpenSpace( int number, EntityType type )
     }
 }
 
+//-----------------------------------------------------------------------------
+// Debug load for the collision broadphase
+void Map::SpawnCollisionStressEntities( int numTanks, int numBullets )
+{
+    SpawnNewEntitiesOfTypeInOpenSpace( numTanks, ENTITY_ENEMY_TANK );
+
+    RandomNumberGenerator* rng = g_GameInstance->GetRng();
+    for( int bulletIndex = 0; bulletIndex < numBullets; ++bulletIndex )
+    {
+        Vec2 spawnPosition = FindPointNotInWall( AABB2::UNIT_BOX.GetDimensions() );
+        Bullet* bullet = static_cast<Bullet*>(SpawnNewEntity( ENTITY_BULLET_ENEMY, spawnPosition ));
+        bullet->SetBulletDireciton( Vec2::MakeFromPolarDegrees( rng->FloatLessThan( 360.f ) ) );
+    }
+}
+
 void Map::RequestRespawn( PlayerCharacter* entityToRespawn )
 {
     entityToRespawn->SetPosition( static_cast<Vec3>(static_cast<Vec2>(m_StartLocation)) );
@@ -181,7 +422,7 @@ void Map::AddEntityToMapAtStart( Entity* entity )
 void Map::AddEntityToMap( Entity* entity, const Vec2& spawnPosition )
 {
     entity->SetPosition( static_cast<Vec3>(spawnPosition) );
-    m_EntityListsByType[ entity->GetEntityType() ].RapidReplace( entity );
+    AddEntityToMap( entity->GetEntityType(), entity );
 }
 
 bool Map::IsValidTilePos( const IntVec2& testPos ) const
@@ -193,7 +434,8 @@ bool Map::IsValidTilePos( const IntVec2& testPos ) const
 
 const IntVec2 Map::GetTilePositionFromWorldCoords( const Vec2& worldCoords ) const
 {
-    return IntVec2( (int)worldCoords.x, (int)worldCoords.y );
+    // Floored so points just below zero land outside the map instead of on tile 0
+    return IntVec2( static_cast<int>(floorf( worldCoords.x )), static_cast<int>(floorf( worldCoords.y )) );
 }
 
 const IntVec2 Map::GetTilePositionFromIndex( int index ) const
@@ -208,18 +450,44 @@ int Map::GetTileIndexFromPosition( const IntVec2& position ) const
 
 bool Map::IsTileSolid( const Tile& tile ) const
 {
-    return tile.IsSolid();
+    return m_SolidTiles.IsSet( tile.GetTilePosition() );
 }
 
 bool Map::DoseTileBlockRaycast( const Tile& tile ) const
 {
-    return tile.DoesBlockRaycast();
+    return m_RaycastBlockingTiles.IsSet( tile.GetTilePosition() );
+}
+
+bool Map::DoesTileBlockProjectiles( const Tile& tile ) const
+{
+    return m_ProjectileBlockingTiles.IsSet( tile.GetTilePosition() );
 }
 
 void Map::SetTypeOfTile( const IntVec2& positions, TileType tileType )
 {
     int tileIndex = GetTileIndexFromPosition( positions );
-    m_Tiles.at( tileIndex ).SetTileType( tileType );
+    Tile& tile = m_Tiles.at( tileIndex );
+    bool wasSolid = IsTileSolid( tile );
+    bool wasMud = tile.GetTileType() == TILE_MUD;
+    bool didBlockRaycast = DoseTileBlockRaycast( tile );
+    tile.SetTileType( tileType );
+    UpdateTileBitmaps( tile );
+    if( IsTileSolid( tile ) != wasSolid )
+    {
+        m_WallDistanceField.UpdateAroundTile( m_SolidTiles, positions );
+        m_SolidNeighborMasks.UpdateAroundTile( m_SolidTiles, positions );
+    }
+    if( (tileType == TILE_MUD) != wasMud )
+    {
+        m_MudNeighborMasks.UpdateAroundTile( m_MudTiles, positions );
+    }
+    MarkTileRenderChunkDirtyAt( positions );
+    if( DoseTileBlockRaycast( tile ) != didBlockRaycast )
+    {
+        m_PotentiallyVisibleSet.RebakeAroundTile( m_RaycastBlockingTiles, positions );
+    }
+    MarkFogOfWarDirtyAt( positions );
+    m_LineOfSightCache.clear();
 }
 
 void Map::SetTilePositionVisable( const IntVec2& position )
@@ -227,11 +495,30 @@ void Map::SetTilePositionVisable( const IntVec2& position )
     if( IsValidTilePos( position ) )
     {
         Tile& tileToSet = m_Tiles.at( GetTileIndexFromPosition( position ) );
-        tileToSet.SetTileIsSeen( false );
-        tileToSet.SetTileCurrentSeen( true );
+        SetTileIsSeen( tileToSet, false );
+        SetTileCurrentSeen( tileToSet, true );
+        m_SlatedVisibleTiles.push_back( position );
     }
 }
 
+// Fog of war writes tile state through these so only the chunks that
+// actually changed get rebuilt
+void Map::SetTileIsSeen( Tile& tile, bool wasSeen )
+{
+    if( tile.IsSeen() == wasSeen ) { return; }
+
+    tile.SetTileIsSeen( wasSeen );
+    MarkTileRenderChunkDirtyAt( tile.GetTilePosition() );
+}
+
+void Map::SetTileCurrentSeen( Tile& tile, bool isCurrentSeen )
+{
+    if( tile.IsTileCurrentSeen() == isCurrentSeen ) { return; }
+
+    tile.SetTileCurrentSeen( isCurrentSeen );
+    MarkTileRenderChunkDirtyAt( tile.GetTilePosition() );
+}
+
 const Tile* Map::GetTileFromIndex( int index ) const
 {
     return &m_Tiles.at( index );
@@ -257,88 +544,481 @@ RayCastHit Map::RayCastSolid( const Vec2& start, float angleDegrees, float maxDi
 
 RayCastHit Map::RayCastSolid( const Vec2& start, const Vec2& direciton, float maxDist ) const
 {
-    constexpr float RAYCAST_STEP = 1.f / 50.f;
+    return RayCastTiles( start, direciton, maxDist, &Map::IsTilePositionSolid );
+}
+
+RayCastHit Map::RayCastVisual( const Vec2& start, float angleDegrees, float maxDist ) const
+{
+    return RayCastVisual( start, Vec2::MakeFromPolarDegrees( angleDegrees ), maxDist );
+}
+
+RayCastHit Map::RayCastVisual( const Vec2& start, const Vec2& direciton, float maxDist ) const
+{
+    return RayCastTiles( start, direciton, maxDist, &Map::DoesTilePositionBlockRaycast );
+}
+
+bool Map::HasLineOfSight( const Entity& entity1, const Entity& entity2, float maxDist ) const
+{
+    Vec3 entityDisplacement = entity2.GetPosition() - entity1.GetPosition();
+    if( entityDisplacement.GetLengthSquared() > (maxDist * maxDist) )
+    {
+        return false;
+    }
+
+    IntVec2 tilePos1 = GetTilePositionFromWorldCoords( static_cast<Vec2>(entity1.GetPosition()) );
+    IntVec2 tilePos2 = GetTilePositionFromWorldCoords( static_cast<Vec2>(entity2.GetPosition()) );
+    // The baked set is from tile centers, only trust it to rule a pair out
+    if( m_PotentiallyVisibleSet.GetVisibility( tilePos1, tilePos2 ) == PVS_NOT_VISIBLE )
+    {
+        return false;
+    }
+
+    uint32_t snappedPosition1 = GetLineOfSightCachePosition( static_cast<Vec2>(entity1.GetPosition()) );
+    uint32_t snappedPosition2 = GetLineOfSightCachePosition( static_cast<Vec2>(entity2.GetPosition()) );
+    uint64_t lowPosition = snappedPosition1 < snappedPosition2 ? snappedPosition1 : snappedPosition2;
+    uint64_t highPosition = snappedPosition1 < snappedPosition2 ? snappedPosition2 : snappedPosition1;
+    uint64_t cacheKey = (highPosition << 32) | lowPosition;
+
+    auto cachedResult = m_LineOfSightCache.find( cacheKey );
+    if( cachedResult != m_LineOfSightCache.end() )
+    {
+        ++m_LineOfSightCacheHits;
+        return cachedResult->second;
+    }
+    ++m_LineOfSightCacheMisses;
+
+    RayCastHit ray = RayCastVisual( static_cast<Vec2>(entity1.GetPosition()),
+                                    entityDisplacement.GetAngleAboutZDegrees(),
+                                    entityDisplacement.GetLength()
+                                  );
+    m_LineOfSightCache[ cacheKey ] = !ray.didHit;
+    return !ray.didHit;
+}
+
+void Map::RayCastSolidBatch( const Vec2* starts,
+                             const Vec2* directions,
+                             const float* maxDists,
+                             int numRays,
+                             RayCastHit* out_hits ) const
+{
+    RayCastTilesBatch( m_SolidTiles, starts, directions, maxDists, numRays, out_hits );
+}
+
+void Map::RayCastVisualBatch( const Vec2* starts,
+                              const Vec2* directions,
+                              const float* maxDists,
+                              int numRays,
+                              RayCastHit* out_hits ) const
+{
+    RayCastTilesBatch( m_RaycastBlockingTiles, starts, directions, maxDists, numRays, out_hits );
+}
+
+//-----------------------------------------------------------------------------
+// Times the scalar and batched ray casts over the same random rays and
+// reports any rays where the two disagree
+void Map::BenchmarkRayCasts( int numRays ) const
+{
+    if( numRays <= 0 ) { return; }
 
-    Vec2 position = start;
-    Vec2 previous = Vec2::ZERO;
+    std::vector<Vec2> starts;
+    std::vector<Vec2> directions;
+    std::vector<float> maxDists;
+    starts.reserve( numRays );
+    directions.reserve( numRays );
+    maxDists.reserve( numRays );
 
-    bool wasObjectHit = true;
-    while( !IsPointInSolid( position ) )
+    RandomNumberGenerator* rng = g_GameInstance->GetRng();
+    for( int rayIndex = 0; rayIndex < numRays; ++rayIndex )
     {
-        previous = position;
-        position += direciton * RAYCAST_STEP;
+        starts.push_back( Vec2( rng->FloatInRange( 0.f, static_cast<float>(m_Size.x) ),
+                                rng->FloatInRange( 0.f, static_cast<float>(m_Size.y) ) ) );
+        directions.push_back( Vec2::MakeFromPolarDegrees( rng->FloatInRange( 0.f, 360.f ) ) );
+        maxDists.push_back( rng->FloatInRange( 1.f, 20.f ) );
+    }
+
+    std::vector<RayCastHit> scalarHits;
+    scalarHits.reserve( numRays );
+    double scalarStartTime = GetCurrentTimeSeconds();
+    for( int rayIndex = 0; rayIndex < numRays; ++rayIndex )
+    {
+        scalarHits.push_back( RayCastVisual( starts[ rayIndex ], directions[ rayIndex ], maxDists[ rayIndex ] ) );
+    }
+    double scalarSeconds = GetCurrentTimeSeconds() - scalarStartTime;
 
-        if( (position - start).GetLength() >= maxDist )
+    std::vector<RayCastHit> batchHits( numRays );
+    double batchStartTime = GetCurrentTimeSeconds();
+    RayCastVisualBatch( starts.data(), directions.data(), maxDists.data(), numRays, batchHits.data() );
+    double batchSeconds = GetCurrentTimeSeconds() - batchStartTime;
+
+    int numMismatches = 0;
+    for( int rayIndex = 0; rayIndex < numRays; ++rayIndex )
+    {
+        const RayCastHit& scalarHit = scalarHits[ rayIndex ];
+        const RayCastHit& batchHit = batchHits[ rayIndex ];
+        if( scalarHit.didHit != batchHit.didHit ||
+            scalarHit.hitTilePosition != batchHit.hitTilePosition )
         {
-            wasObjectHit = false;
-            break;
+            ++numMismatches;
         }
     }
 
-    if( position == start )
+    DebuggerPrintf( "RayCast benchmark, %i rays: scalar %.3fms, batch %.3fms, %i mismatches\n",
+                    numRays,
+                    scalarSeconds * 1000.0,
+                    batchSeconds * 1000.0,
+                    numMismatches );
+}
+
+//-----------------------------------------------------------------------------
+// A swept entity is only in the cell it ended in, so it looks up the cells
+// along its whole path
+static void GetGridEntriesNearEntity( const EntityGrid& grid, const Entity* entity, std::vector<EntityGridEntry>& out_entries )
+{
+    if( !entity->UsesSweptCollision() )
     {
-        return RayCastHit( true, start, 0.f );
+        grid.GetEntriesNear( static_cast<Vec2>(entity->GetPosition()), out_entries );
+        return;
     }
-    else
+
+    Vec2 start = static_cast<Vec2>(entity->GetPreviousPosition());
+    Vec2 end = static_cast<Vec2>(entity->GetPosition());
+    grid.GetEntriesNearBox( Vec2( fminf( start.x, end.x ), fminf( start.y, end.y ) ),
+                            Vec2( fmaxf( start.x, end.x ), fmaxf( start.y, end.y ) ),
+                            out_entries );
+}
+
+// Each grid pair is handled from the lower list, or from the swept side when
+// only one of the two is swept since the other may not see it
+static bool IsGridPairOwnedBy( EntityListIndex l1, const Entity* entity1, EntityListIndex l2, const Entity* entity2 )
+{
+    bool isSwept1 = entity1->UsesSweptCollision();
+    bool isSwept2 = entity2->UsesSweptCollision();
+    if( isSwept1 != isSwept2 ) { return isSwept1; }
+    return l2 >= l1;
+}
+
+// Orders each pair by list, then groups pairs by their first list
+static void SortBroadphasePairsByList( std::vector<EntityGridPair>& pairs )
+{
+    for( int pairIndex = 0; pairIndex < pairs.size(); ++pairIndex )
     {
-        Vec2 avg( (previous.x + position.x) * .5f, (previous.y + position.y) * .5f );
-        Vec2 finishDisp = direciton * maxDist;
-        Vec2 reachedDisplace = avg - start;
-        float finishPercent = ClampZeroToOne( reachedDisplace.GetLength() / finishDisp.GetLength() );
-        return RayCastHit( wasObjectHit, avg, finishPercent );
+        EntityGridPair& pair = pairs[ pairIndex ];
+        if( pair.second.listIndex < pair.first.listIndex )
+        {
+            std::swap( pair.first, pair.second );
+        }
     }
+    std::sort( pairs.begin(), pairs.end(), []( const EntityGridPair& pair1, const EntityGridPair& pair2 ) {
+        return pair1.first.listIndex < pair2.first.listIndex;
+    } );
 }
 
-RayCastHit Map::RayCastVisual( const Vec2& start, float angleDegrees, float maxDist ) const
+//-----------------------------------------------------------------------------
+// Only pairs that reach the narrow phase are counted, so all three backends
+// should agree on the overlap count
+static bool IsBenchmarkPairOverlapping( const Entity* entity1, const Entity* entity2 )
 {
-    return RayCastVisual( start, Vec2::MakeFromPolarDegrees( angleDegrees ), maxDist );
+    if( entity1 == entity2 ) { return false; }
+    if( Entity::OverlapsWith( entity1, entity2 ) == EntityOverlapType::NONE ) { return false; }
+    return DoDiscsOverlap( entity1->GetEntityPhysicsDisc(), entity2->GetEntityPhysicsDisc() );
 }
 
-RayCastHit Map::RayCastVisual( const Vec2& start, const Vec2& direciton, float maxDist ) const
+void Map::BenchmarkBroadphases( int numFrames ) const
 {
-    constexpr float RAYCAST_STEP = 1.f / 50.f;
+    if( numFrames <= 0 ) { return; }
+
+    int numBruteForcePairs = 0;
+    int numBruteForceOverlaps = 0;
+    double bruteForceStartTime = GetCurrentTimeSeconds();
+    for( int frameIndex = 0; frameIndex < numFrames; ++frameIndex )
+    {
+        numBruteForcePairs = 0;
+        numBruteForceOverlaps = 0;
+        for( int listIndex1 = 0; listIndex1 < NUM_ENTITY_TYPES; ++listIndex1 )
+        {
+            const EntityList& list1 = m_EntityListsByType[ listIndex1 ];
+            for( int listIndex2 = listIndex1; listIndex2 < NUM_ENTITY_TYPES; ++listIndex2 )
+            {
+                if( !Entity::DoEntityListsOverlap( listIndex1, listIndex2 ) ) { continue; }
 
-    Vec2 position = start;
+                const EntityList& list2 = m_EntityListsByType[ listIndex2 ];
+                for( int entityIndex1 = 0; entityIndex1 < list1.data.size(); ++entityIndex1 )
+                {
+                    int firstEntityIndex2 = listIndex1 == listIndex2 ? entityIndex1 + 1 : 0;
+                    for( int entityIndex2 = firstEntityIndex2; entityIndex2 < list2.data.size(); ++entityIndex2 )
+                    {
+                        ++numBruteForcePairs;
+                        if( IsBenchmarkPairOverlapping( list1.data[ entityIndex1 ], list2.data[ entityIndex2 ] ) )
+                        {
+                            ++numBruteForceOverlaps;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    double bruteForceSeconds = (GetCurrentTimeSeconds() - bruteForceStartTime) / numFrames;
+
+    EntityGrid grid;
+    std::vector<EntityGridEntry> nearbyEntities;
+    int numGridPairs = 0;
+    int numGridOverlaps = 0;
+    double gridStartTime = GetCurrentTimeSeconds();
+    for( int frameIndex = 0; frameIndex < numFrames; ++frameIndex )
+    {
+        numGridPairs = 0;
+        numGridOverlaps = 0;
+        grid.Rebuild( m_EntityListsByType, NUM_ENTITY_TYPES, m_Size );
+        for( int listIndex1 = 0; listIndex1 < NUM_ENTITY_TYPES; ++listIndex1 )
+        {
+            const EntityList& list1 = m_EntityListsByType[ listIndex1 ];
+            for( int entityIndex1 = 0; entityIndex1 < list1.data.size(); ++entityIndex1 )
+            {
+                const Entity* entity1 = list1.data[ entityIndex1 ];
 
-    bool wasObjectHit = true;
-    while( !IsPointBlockRaycast( position ) )
+                nearbyEntities.clear();
+                GetGridEntriesNearEntity( grid, entity1, nearbyEntities );
+                for( int nearbyIndex = 0; nearbyIndex < nearbyEntities.size(); ++nearbyIndex )
+                {
+                    const EntityGridEntry& nearby = nearbyEntities[ nearbyIndex ];
+                    const Entity* entity2 = m_EntityListsByType[ nearby.listIndex ].data[ nearby.entityIndex ];
+                    if( !IsGridPairOwnedBy( listIndex1, entity1, nearby.listIndex, entity2 ) ) { continue; }
+                    if( !Entity::DoEntityListsOverlap( listIndex1, nearby.listIndex ) ) { continue; }
+
+                    ++numGridPairs;
+                    // Same list pairs come up from both sides, count one
+                    if( nearby.listIndex == listIndex1 && nearby.entityIndex < entityIndex1 ) { continue; }
+                    if( IsBenchmarkPairOverlapping( entity1, entity2 ) )
+                    {
+                        ++numGridOverlaps;
+                    }
+                }
+            }
+        }
+    }
+    double gridSeconds = (GetCurrentTimeSeconds() - gridStartTime) / numFrames;
+
+    // The first update sorts from scratch, later ones only fix up the order
+    SweepAndPrune sweepAndPrune;
+    std::vector<EntityGridPair> pairs;
+    int numSweepAndPrunePairs = 0;
+    int numSweepAndPruneOverlaps = 0;
+    double coldSweepAndPruneSeconds = 0.0;
+    double sweepAndPruneStartTime = GetCurrentTimeSeconds();
+    for( int frameIndex = 0; frameIndex <= numFrames; ++frameIndex )
     {
-        position += direciton * RAYCAST_STEP;
+        if( frameIndex == 1 )
+        {
+            coldSweepAndPruneSeconds = GetCurrentTimeSeconds() - sweepAndPruneStartTime;
+            sweepAndPruneStartTime = GetCurrentTimeSeconds();
+        }
 
-        float distance = (position - start).GetLength();
-        if( distance > maxDist || distance == 0 )
+        numSweepAndPrunePairs = 0;
+        numSweepAndPruneOverlaps = 0;
+        pairs.clear();
+        sweepAndPrune.Update( m_EntityListsByType, NUM_ENTITY_TYPES );
+        sweepAndPrune.GetPairs( pairs );
+        for( int pairIndex = 0; pairIndex < pairs.size(); ++pairIndex )
         {
-            wasObjectHit = false;
-            break;
+            const EntityGridPair& pair = pairs[ pairIndex ];
+            if( !Entity::DoEntityListsOverlap( pair.first.listIndex, pair.second.listIndex ) ) { continue; }
+
+            ++numSweepAndPrunePairs;
+            if( IsBenchmarkPairOverlapping( m_EntityListsByType[ pair.first.listIndex ].data[ pair.first.entityIndex ],
+                                            m_EntityListsByType[ pair.second.listIndex ].data[ pair.second.entityIndex ] ) )
+            {
+                ++numSweepAndPruneOverlaps;
+            }
         }
     }
+    double sweepAndPruneSeconds = (GetCurrentTimeSeconds() - sweepAndPruneStartTime) / numFrames;
+
+    DebuggerPrintf( "Broadphase benchmark, %i frames, map %ix%i, %i entities:\n",
+                    numFrames,
+                    m_Size.x,
+                    m_Size.y,
+                    sweepAndPrune.GetNumProxies() );
+    DebuggerPrintf( "  brute force:     %.3fms, %i pairs, %i overlaps\n",
+                    bruteForceSeconds * 1000.0,
+                    numBruteForcePairs,
+                    numBruteForceOverlaps );
+    DebuggerPrintf( "  grid:            %.3fms, %i pairs, %i overlaps\n",
+                    gridSeconds * 1000.0,
+                    numGridPairs,
+                    numGridOverlaps );
+    DebuggerPrintf( "  sweep and prune: %.3fms (first frame %.3fms), %i pairs, %i overlaps\n",
+                    sweepAndPruneSeconds * 1000.0,
+                    coldSweepAndPruneSeconds * 1000.0,
+                    numSweepAndPrunePairs,
+                    numSweepAndPruneOverlaps );
+}
+
+//-----------------------------------------------------------------------------
+// Times the old per tile wall push out against the neighbor mask kernel over
+// the same random discs and reports any discs where the two disagree
+void Map::BenchmarkTileCollisions( int numDiscs ) const
+{
+    if( numDiscs <= 0 ) { return; }
+
+    std::vector<Vec2> centers;
+    std::vector<float> radii;
+    std::vector<IntVec2> tilePositions;
+    centers.reserve( numDiscs );
+    radii.reserve( numDiscs );
+    tilePositions.reserve( numDiscs );
 
-    if( position == start )
+    RandomNumberGenerator* rng = g_GameInstance->GetRng();
+    for( int discIndex = 0; discIndex < numDiscs; ++discIndex )
     {
-        return RayCastHit( true, start, 0.f );
+        centers.push_back( Vec2( rng->FloatInRange( 0.f, static_cast<float>(m_Size.x) ),
+                                 rng->FloatInRange( 0.f, static_cast<float>(m_Size.y) ) ) );
+        radii.push_back( rng->FloatInRange( .2f, .5f ) );
+        tilePositions.push_back( GetTilePositionFromWorldCoords( centers.back() ) );
     }
-    else
+
+    // Each neighbor looked up as a Tile and tested against its bounding box
+    std::vector<Vec2> scalarCenters = centers;
+    double scalarStartTime = GetCurrentTimeSeconds();
+    for( int discIndex = 0; discIndex < numDiscs; ++discIndex )
+    {
+        Disc disc = Disc( scalarCenters[ discIndex ], radii[ discIndex ] );
+        for( int neighborIndex = 0; neighborIndex < NUM_TILE_NEIGHBORS; ++neighborIndex )
+        {
+            const Tile* tile = GetTileFromPosition( tilePositions[ discIndex ] + TILE_NEIGHBOR_OFFSETS[ neighborIndex ] );
+            if( tile == nullptr || !IsTileSolid( *tile ) ) { continue; }
+
+            if( DoAABB2OverlapDisc( tile->GetTileBoundingBox(), disc ) )
+            {
+                disc.PushOutOfAABB2Fixed( tile->GetTileBoundingBox() );
+            }
+        }
+        scalarCenters[ discIndex ] = disc.center;
+    }
+    double scalarSeconds = GetCurrentTimeSeconds() - scalarStartTime;
+
+    std::vector<Vec2> batchCenters = centers;
+    std::vector<uint8_t> masks( numDiscs );
+    double batchStartTime = GetCurrentTimeSeconds();
+    for( int discIndex = 0; discIndex < numDiscs; ++discIndex )
     {
-        Vec2 finishDisp = direciton * maxDist;
-        Vec2 reachedDisplace = position - start;
-        float finishPercent = ClampZeroToOne( reachedDisplace.GetLength() / finishDisp.GetLength() );
-        return RayCastHit( wasObjectHit, position, finishPercent );
+        masks[ discIndex ] = m_SolidNeighborMasks.GetMask( tilePositions[ discIndex ] );
+    }
+    PushDiscsOutOfNeighborTiles( batchCenters.data(), radii.data(), tilePositions.data(), masks.data(), numDiscs );
+    double batchSeconds = GetCurrentTimeSeconds() - batchStartTime;
+
+    int numMismatches = 0;
+    for( int discIndex = 0; discIndex < numDiscs; ++discIndex )
+    {
+        if( (scalarCenters[ discIndex ] - batchCenters[ discIndex ]).GetLengthSquared() > 1e-8f )
+        {
+            ++numMismatches;
+        }
     }
+
+    DebuggerPrintf( "Tile collision benchmark, %i discs: per tile %.3fms, neighbor masks %.3fms, %i mismatches\n",
+                    numDiscs,
+                    scalarSeconds * 1000.0,
+                    batchSeconds * 1000.0,
+                    numMismatches );
 }
 
-bool Map::HasLineOfSight( const Entity& entity1, const Entity& entity2, float maxDist ) const
+//-----------------------------------------------------------------------------
+// Amanatides-Woo grid traversal, each tile the ray crosses is visited once
+RayCastHit Map::RayCastTiles( const Vec2& start,
+                              const Vec2& direction,
+                              float maxDist,
+                              TileBlockTest doesTileBlock ) const
 {
-    Vec3 entityDisplacement = entity2.GetPosition() - entity1.GetPosition();
-    if( entityDisplacement.GetLengthSquared() > (maxDist * maxDist) )
+    IntVec2 tilePos = GetTilePositionFromWorldCoords( start );
+    if( (this->*doesTileBlock)( tilePos ) )
     {
-        return false;
+        return RayCastHit( true, start, 0.f, tilePos );
     }
 
-    RayCastHit ray = RayCastVisual( static_cast<Vec2>(entity1.GetPosition()),
-                                    entityDisplacement.GetAngleAboutZDegrees(),
-                                    entityDisplacement.GetLength()
-                                  );
-    return !ray.didHit;
+    float directionLength = direction.GetLength();
+    if( directionLength == 0.f || maxDist <= 0.f )
+    {
+        return RayCastHit( false, start, 1.f, tilePos );
+    }
+    Vec2 forward = direction / directionLength;
+
+    constexpr float NEVER_CROSSES = std::numeric_limits<float>::infinity();
+
+    // Distance along the ray to cross a whole tile on each axis
+    float deltaDistX = forward.x != 0.f ? fabsf( 1.f / forward.x ) : NEVER_CROSSES;
+    float deltaDistY = forward.y != 0.f ? fabsf( 1.f / forward.y ) : NEVER_CROSSES;
+
+    // Distance along the ray to the first tile edge on each axis
+    int stepX = forward.x > 0.f ? 1 : -1;
+    int stepY = forward.y > 0.f ? 1 : -1;
+    float firstEdgeX = stepX > 0 ? static_cast<float>(tilePos.x + 1) - start.x : start.x - static_cast<float>(tilePos.x);
+    float firstEdgeY = stepY > 0 ? static_cast<float>(tilePos.y + 1) - start.y : start.y - static_cast<float>(tilePos.y);
+    float nextCrossX = forward.x != 0.f ? firstEdgeX * deltaDistX : NEVER_CROSSES;
+    float nextCrossY = forward.y != 0.f ? firstEdgeY * deltaDistY : NEVER_CROSSES;
+
+    while( true )
+    {
+        float crossDist = 0.f;
+        if( nextCrossX < nextCrossY )
+        {
+            crossDist = nextCrossX;
+            if( crossDist > maxDist ) { break; }
+
+            tilePos.x += stepX;
+            nextCrossX += deltaDistX;
+        }
+        else
+        {
+            crossDist = nextCrossY;
+            if( crossDist > maxDist ) { break; }
+
+            tilePos.y += stepY;
+            nextCrossY += deltaDistY;
+        }
+
+        if( (this->*doesTileBlock)( tilePos ) )
+        {
+            return RayCastHit( true, start + forward * crossDist, crossDist / maxDist, tilePos );
+        }
+    }
+
+    return RayCastHit( false, start + forward * maxDist, 1.f, tilePos );
+}
+
+void Map::UpdateTileBitmaps( const Tile& tile )
+{
+    const IntVec2 tilePos = tile.GetTilePosition();
+    m_SolidTiles.Set( tilePos, tile.IsSolid() );
+    m_RaycastBlockingTiles.Set( tilePos, tile.DoesBlockRaycast() );
+    m_ProjectileBlockingTiles.Set( tilePos, tile.DoesBlockProjectiles() );
+    m_MudTiles.Set( tilePos, tile.GetTileType() == TILE_MUD );
+}
+
+// 16 bits per axis, enough for maps 4096 tiles across
+uint32_t Map::GetLineOfSightCachePosition( const Vec2& position ) const
+{
+    uint32_t snappedX = static_cast<uint32_t>(position.x * MAP_LINE_OF_SIGHT_CACHE_STEPS_PER_TILE) & 0xffffu;
+    uint32_t snappedY = static_cast<uint32_t>(position.y * MAP_LINE_OF_SIGHT_CACHE_STEPS_PER_TILE) & 0xffffu;
+    return (snappedY << 16) | snappedX;
+}
+
+void Map::ClearLineOfSightCache()
+{
+    m_LineOfSightCache.clear();
+    m_LineOfSightCacheHits = 0;
+    m_LineOfSightCacheMisses = 0;
+}
+
+bool Map::IsTilePositionSolid( const IntVec2& tilePos ) const
+{
+    if( !IsValidTilePos( tilePos ) ) { return true; }
+    return m_SolidTiles.IsSet( tilePos );
+}
+
+bool Map::DoesTilePositionBlockRaycast( const IntVec2& tilePos ) const
+{
+    if( !IsValidTilePos( tilePos ) ) { return true; }
+    return m_RaycastBlockingTiles.IsSet( tilePos );
 }
 
 void Map::UpdateEntities( float deltaSeconds )
@@ -349,13 +1029,12 @@ void Map::UpdateEntities( float deltaSeconds )
 
         for( int entityIndex = 0; entityIndex < currentEntityList.data.size(); ++entityIndex )
         {
-            Entity*& currentEntity = currentEntityList.data.at( entityIndex );
-            if( currentEntity != nullptr )
-            {
-                currentEntity->Update( deltaSeconds );
-            }
+            Entity* currentEntity = currentEntityList.data[ entityIndex ];
+            currentEntity->Update( deltaSeconds );
         }
     }
+
+    m_EntityKinematics.Integrate();
 }
 
 void Map::UpdateFogOfWar( EntityType revealForEntityType, int fieldOfView, int viewHeight, float viewAspect )
@@ -367,11 +1046,18 @@ void Map::UpdateFogOfWar( EntityType revealForEntityType, int fieldOfView, int v
     int tileVectorSize = 2 * fieldOfView * fieldOfView + 2 * fieldOfView;
     const EntityList& fogOfWarList = m_EntityListsByType[ revealForEntityType ];
 
+    m_FogOfWarViewExtents = IntVec2( outerX, outerY );
+    if( !IsFogOfWarStale( fogOfWarList ) )
+    {
+        UpdateFogOfWarOnSlatedTiles( fogOfWarList );
+        return;
+    }
+    m_SlatedVisibleTiles.clear();
+
     // For each entity in the list
     for( int playerIndex = 0; playerIndex < fogOfWarList.data.size(); ++playerIndex )
     {
         const Entity* const& currentPlayerEntity = fogOfWarList.data.at( playerIndex );
-        if( currentPlayerEntity == nullptr ) { continue; }
         if( currentPlayerEntity->IsDead() || currentPlayerEntity->IsGarbage() ) { return; }
 
         // Get the tile position of entity
@@ -380,7 +1066,7 @@ void Map::UpdateFogOfWar( EntityType revealForEntityType, int fieldOfView, int v
                                                                 );
 
         // Create vector of tiles in field of view
-        std::vector<Tile*> potentialTiles;
+        FrameVector<Tile*> potentialTiles( g_FrameArena->GetAllocator<Tile*>() );
         potentialTiles.reserve( tileVectorSize );
 
         // For all the tiles in a outerFieldOfView * 2 + 1 box around the entity
@@ -401,105 +1087,336 @@ void Map::UpdateFogOfWar( EntityType revealForEntityType, int fieldOfView, int v
                 // Specific test to check if tile was slated to be added by a entity
                 if( !tileToTest->IsSeen() && tileToTest->IsTileCurrentSeen() )
                 {
-                    tileToTest->SetTileCurrentSeen( true );
+                    SetTileCurrentSeen( *tileToTest, true );
                     potentialTiles.push_back( tileToTest );
                     continue;
                 }
                 else
                 {
-                    tileToTest->SetTileCurrentSeen( false );
+                    SetTileCurrentSeen( *tileToTest, false );
                 }
 
                 if( tilePosOfEntity == testPos )
                 {
-                    tileToTest->SetTileCurrentSeen( true );
-                    tileToTest->SetTileIsSeen( true );
+                    SetTileCurrentSeen( *tileToTest, true );
+                    SetTileIsSeen( *tileToTest, true );
                     continue;
                 }
 
                 // If the tile can be tested for visible, add it to the list
-                if( IntVec2::GetTaxicabDistance( tilePosOfEntity, testPos ) <= fieldOfView )
+                if( g_PerTileRaycastFog &&
+                    IntVec2::GetTaxicabDistance( tilePosOfEntity, testPos ) <= fieldOfView )
                 {
                     potentialTiles.push_back( tileToTest );
                 }
             }
         }
+
+        if( !g_PerTileRaycastFog )
+        {
+            ShadowcastFogOfWarFrom( tilePosOfEntity, fieldOfView );
+        }
         UpdateFogOfWarOnTilesFrom( currentPlayerEntity, potentialTiles );
     }
 }
 
-void Map::UpdateFogOfWarOnTilesFrom( const Entity* const& entity, std::vector<Tile*>& tiles )
+// One ray per tile, cast together through the batched ray caster
+void Map::UpdateFogOfWarOnTilesFrom( const Entity* const& entity, FrameVector<Tile*>& tiles )
 {
-    for( int tileIndex = 0; tileIndex < tiles.size(); ++tileIndex )
+    int numRays = static_cast<int>(tiles.size());
+    if( numRays == 0 ) { return; }
+
+    Vec2 entityPosition = static_cast<Vec2>(entity->GetPosition());
+    FrameVector<Vec2> starts( numRays, entityPosition, g_FrameArena->GetAllocator<Vec2>() );
+    FrameVector<Vec2> directions( g_FrameArena->GetAllocator<Vec2>() );
+    FrameVector<float> maxDists( g_FrameArena->GetAllocator<float>() );
+    FrameVector<RayCastHit> tileRaycastHits( numRays, RayCastHit(), g_FrameArena->GetAllocator<RayCastHit>() );
+    directions.reserve( numRays );
+    maxDists.reserve( numRays );
+    for( int tileIndex = 0; tileIndex < numRays; ++tileIndex )
     {
-        Tile* currentTile = tiles.at( tileIndex );
-
         // Get the direction to the tile
-        Vec2 tileCenter = currentTile->GetTileBoundingBox().GetCenter();
-        Vec2 raycastDisplacement = tileCenter - static_cast<Vec2>(entity->GetPosition());
+        Vec2 tileCenter = tiles.at( tileIndex )->GetTileBoundingBox().GetCenter();
+        Vec2 raycastDisplacement = tileCenter - entityPosition;
+        directions.push_back( raycastDisplacement.GetNormalized() );
+        maxDists.push_back( raycastDisplacement.GetLength() );
+    }
 
-        RayCastHit tileRaycastHit = RayCastVisual( static_cast<Vec2>(entity->GetPosition()),
-                                                   raycastDisplacement.GetNormalized(),
-                                                   raycastDisplacement.GetLength()
-                                                 );
+    RayCastVisualBatch( starts.data(), directions.data(), maxDists.data(), numRays, tileRaycastHits.data() );
 
-        IntVec2 tilePosOfHit = GetTilePositionFromWorldCoords( tileRaycastHit.hitPosition );
+    for( int tileIndex = 0; tileIndex < numRays; ++tileIndex )
+    {
+        IntVec2 tilePosOfHit = tileRaycastHits[ tileIndex ].hitTilePosition;
         if( IsValidTilePos( tilePosOfHit ) )
         {
             Tile& hitTile = m_Tiles[ GetTileIndexFromPosition( tilePosOfHit ) ];
 
-            hitTile.SetTileIsSeen( true );
-            hitTile.SetTileCurrentSeen( true );
+            SetTileIsSeen( hitTile, true );
+            SetTileCurrentSeen( hitTile, true );
         }
     }
 }
 
-void Map::RenderTiles() const
+bool Map::IsFogOfWarStale( const EntityList& fogOfWarList )
 {
-    std::vector<VertexMaster> tileVector;
-    for( int tileIndex = 0; tileIndex < m_Tiles.size(); ++tileIndex )
+    bool isStale = m_IsFogOfWarDirty || m_FogOfWarUsedPerTileRaycast != g_PerTileRaycastFog;
+    if( m_FogOfWarViewerTiles.size() != fogOfWarList.data.size() )
     {
-        const Tile& currentTile = m_Tiles.at( tileIndex );
-        AABB2 tileBounds = AABB2::MakeFromUnitBoxAround( static_cast<Vec2>(currentTile.GetTilePosition()) );
-        if( currentTile.GetTileType() != TILE_INVALID )
+        m_FogOfWarViewerTiles.resize( fogOfWarList.data.size(), IntVec2( -1, -1 ) );
+        isStale = true;
+    }
+
+    for( int playerIndex = 0; playerIndex < fogOfWarList.data.size(); ++playerIndex )
+    {
+        // Dead viewers get an invalid tile so their return is noticed
+        const Entity* const& currentPlayerEntity = fogOfWarList.data.at( playerIndex );
+        IntVec2 viewerTile = IntVec2( -1, -1 );
+        if( !currentPlayerEntity->IsDead() && !currentPlayerEntity->IsGarbage() )
         {
-            // If fog is off, render tiles
-            if( g_NoFog )
-            {
-                AppendTileToVectorPCU( tileVector, currentTile, false );
-            }
-                // If tile is seen
-            else if( currentTile.IsSeen() )
+            viewerTile = GetTilePositionFromWorldCoords( static_cast<Vec2>(currentPlayerEntity->GetPosition()) );
+        }
+
+        if( m_FogOfWarViewerTiles[ playerIndex ] != viewerTile )
+        {
+            m_FogOfWarViewerTiles[ playerIndex ] = viewerTile;
+            isStale = true;
+        }
+    }
+
+    m_IsFogOfWarDirty = false;
+    m_FogOfWarUsedPerTileRaycast = g_PerTileRaycastFog;
+    return isStale;
+}
+
+void Map::UpdateFogOfWarOnSlatedTiles( const EntityList& fogOfWarList )
+{
+    if( m_SlatedVisibleTiles.empty() ) { return; }
+
+    FrameVector<Tile*> slatedTiles( g_FrameArena->GetAllocator<Tile*>() );
+    slatedTiles.reserve( m_SlatedVisibleTiles.size() );
+
+    for( int playerIndex = 0; playerIndex < fogOfWarList.data.size(); ++playerIndex )
+    {
+        const Entity* const& currentPlayerEntity = fogOfWarList.data.at( playerIndex );
+        if( currentPlayerEntity->IsDead() || currentPlayerEntity->IsGarbage() ) { break; }
+
+        // Only slated tiles inside this viewer's fog box get tested, as in a full update
+        const IntVec2& viewerTile = m_FogOfWarViewerTiles[ playerIndex ];
+        slatedTiles.clear();
+        for( int slatedIndex = 0; slatedIndex < m_SlatedVisibleTiles.size(); ++slatedIndex )
+        {
+            const IntVec2& slatedPos = m_SlatedVisibleTiles[ slatedIndex ];
+            if( abs( slatedPos.x - viewerTile.x ) > m_FogOfWarViewExtents.x ) { continue; }
+            if( abs( slatedPos.y - viewerTile.y ) > m_FogOfWarViewExtents.y ) { continue; }
+
+            Tile* slatedTile = &m_Tiles[ GetTileIndexFromPosition( slatedPos ) ];
+            if( !slatedTile->IsSeen() && slatedTile->IsTileCurrentSeen() )
             {
-                AppendTileToVectorPCU( tileVector, currentTile );
+                slatedTiles.push_back( slatedTile );
             }
-            else if( !currentTile.IsSeen() )
+        }
+        UpdateFogOfWarOnTilesFrom( currentPlayerEntity, slatedTiles );
+    }
+
+    m_SlatedVisibleTiles.clear();
+}
+
+void Map::MarkFogOfWarDirtyAt( const IntVec2& tilePos )
+{
+    for( int viewerIndex = 0; viewerIndex < m_FogOfWarViewerTiles.size(); ++viewerIndex )
+    {
+        const IntVec2& viewerTile = m_FogOfWarViewerTiles[ viewerIndex ];
+        if( abs( tilePos.x - viewerTile.x ) <= m_FogOfWarViewExtents.x &&
+            abs( tilePos.y - viewerTile.y ) <= m_FogOfWarViewExtents.y )
+        {
+            m_IsFogOfWarDirty = true;
+            return;
+        }
+    }
+}
+
+void Map::ShadowcastFogOfWarFrom( const IntVec2& tilePosOfEntity, int fieldOfView )
+{
+    // The baked set holds the same shadowcast, so read it when it reaches far enough
+    if( m_PotentiallyVisibleSet.HasTile( tilePosOfEntity ) && fieldOfView <= m_PotentiallyVisibleSet.GetRadius() )
+    {
+        for( int offsetY = -fieldOfView; offsetY <= fieldOfView; ++offsetY )
+        {
+            int rowWidth = fieldOfView - abs( offsetY );
+            for( int offsetX = -rowWidth; offsetX <= rowWidth; ++offsetX )
             {
-                AppendTileDefToVectorPCU( tileVector,
-                                          tileBounds,
-                                          TileDefinition::DEFINITIONS[ TILE_FOG ]
-                                        );
+                IntVec2 tilePos = IntVec2( tilePosOfEntity.x + offsetX, tilePosOfEntity.y + offsetY );
+                if( m_PotentiallyVisibleSet.IsVisibleFromTileCenter( tilePosOfEntity, tilePos ) )
+                {
+                    Tile& visibleTile = m_Tiles[ GetTileIndexFromPosition( tilePos ) ];
+                    SetTileIsSeen( visibleTile, true );
+                    SetTileCurrentSeen( visibleTile, true );
+                }
             }
-            else
+        }
+        return;
+    }
+
+    FrameVector<IntVec2> visibleTiles( g_FrameArena->GetAllocator<IntVec2>() );
+    visibleTiles.reserve( 2 * fieldOfView * fieldOfView + 2 * fieldOfView + 1 );
+    ShadowcastVisibleTiles( m_RaycastBlockingTiles, tilePosOfEntity, fieldOfView, visibleTiles );
+
+    for( int tileIndex = 0; tileIndex < visibleTiles.size(); ++tileIndex )
+    {
+        Tile& visibleTile = m_Tiles[ GetTileIndexFromPosition( visibleTiles[ tileIndex ] ) ];
+        SetTileIsSeen( visibleTile, true );
+        SetTileCurrentSeen( visibleTile, true );
+    }
+}
+
+void Map::RenderTiles( const AABB2& cullBounds ) const
+{
+    m_NumTilesDrawn = 0;
+
+    // Toggling fog changes every tile
+    if( m_AreTileRenderChunksFogless != g_NoFog )
+    {
+        m_AreTileRenderChunksFogless = g_NoFog;
+        for( int chunkIndex = 0; chunkIndex < m_TileRenderChunks.size(); ++chunkIndex )
+        {
+            m_TileRenderChunks[ chunkIndex ].isDirty = true;
+        }
+    }
+
+    // Tile x covers [x, x + 1), so these are the tiles the bounds touch
+    IntVec2 minTile = GetTilePositionFromWorldCoords( cullBounds.mins );
+    IntVec2 maxTile = GetTilePositionFromWorldCoords( cullBounds.maxes );
+    minTile = IntVec2( std::max( minTile.x, 0 ), std::max( minTile.y, 0 ) );
+    maxTile = IntVec2( std::min( maxTile.x, m_Size.x - 1 ), std::min( maxTile.y, m_Size.y - 1 ) );
+    if( minTile.x > maxTile.x || minTile.y > maxTile.y ) { return; }
+
+    // Copy the visible rows out of each cached chunk and draw them together
+    m_VisibleTileVertices.clear();
+    int chunksPerRow = (m_Size.x + MAP_RENDER_CHUNK_SIZE - 1) / MAP_RENDER_CHUNK_SIZE;
+    for( int chunkY = minTile.y / MAP_RENDER_CHUNK_SIZE; chunkY <= maxTile.y / MAP_RENDER_CHUNK_SIZE; ++chunkY )
+    {
+        for( int chunkX = minTile.x / MAP_RENDER_CHUNK_SIZE; chunkX <= maxTile.x / MAP_RENDER_CHUNK_SIZE; ++chunkX )
+        {
+            TileRenderChunk& chunk = m_TileRenderChunks[ chunkY * chunksPerRow + chunkX ];
+            UpdateTileRenderChunk( chunk );
+
+            // Every tile appends one box, so each tile has the same vertex count
+            int chunkWidth = chunk.maxTile.x - chunk.minTile.x + 1;
+            int chunkHeight = chunk.maxTile.y - chunk.minTile.y + 1;
+            int verticesPerTile = static_cast<int>(chunk.vertices.size()) / (chunkWidth * chunkHeight);
+
+            int firstX = std::max( minTile.x, chunk.minTile.x );
+            int lastX = std::min( maxTile.x, chunk.maxTile.x );
+            int firstY = std::max( minTile.y, chunk.minTile.y );
+            int lastY = std::min( maxTile.y, chunk.maxTile.y );
+            for( int tileY = firstY; tileY <= lastY; ++tileY )
             {
-                AppendAABB2( tileVector, tileBounds, Rgba8::MAGENTA );
+                int rowStart = ((tileY - chunk.minTile.y) * chunkWidth + (firstX - chunk.minTile.x)) * verticesPerTile;
+                int rowEnd = rowStart + (lastX - firstX + 1) * verticesPerTile;
+                m_VisibleTileVertices.insert( m_VisibleTileVertices.end(),
+                                              chunk.vertices.begin() + rowStart,
+                                              chunk.vertices.begin() + rowEnd );
             }
+            m_NumTilesDrawn += (lastX - firstX + 1) * (lastY - firstY + 1);
         }
-        else
+    }
+
+    g_Renderer->BindTexture( &m_Tiles.at( 0 ).GetTileDefinition().GetSpriteSheet()->GetTexture() );
+    g_Renderer->DrawVertexArray( m_VisibleTileVertices );
+}
+
+//-----------------------------------------------------------------------------
+void Map::CreateTileRenderChunks()
+{
+    m_TileRenderChunks.clear();
+    for( int chunkMinY = 0; chunkMinY < m_Size.y; chunkMinY += MAP_RENDER_CHUNK_SIZE )
+    {
+        for( int chunkMinX = 0; chunkMinX < m_Size.x; chunkMinX += MAP_RENDER_CHUNK_SIZE )
         {
-            AppendAABB2( tileVector, tileBounds, Rgba8::MAGENTA );
+            TileRenderChunk chunk;
+            chunk.minTile = IntVec2( chunkMinX, chunkMinY );
+            chunk.maxTile = IntVec2( std::min( chunkMinX + MAP_RENDER_CHUNK_SIZE, m_Size.x ) - 1,
+                                     std::min( chunkMinY + MAP_RENDER_CHUNK_SIZE, m_Size.y ) - 1 );
+            m_TileRenderChunks.push_back( chunk );
+            RebuildTileRenderChunk( m_TileRenderChunks.back() );
         }
     }
+    m_AreTileRenderChunksFogless = g_NoFog;
+}
 
-    g_Renderer->BindTexture( &m_Tiles.at( 0 ).GetTileDefinition().GetSpriteSheet()->GetTexture() );
-    g_Renderer->DrawVertexArray( tileVector );
+//-----------------------------------------------------------------------------
+// Chunks are laid out row by row in the order CreateTileRenderChunks makes them
+void Map::MarkTileRenderChunkDirtyAt( const IntVec2& tilePos )
+{
+    int chunksPerRow = (m_Size.x + MAP_RENDER_CHUNK_SIZE - 1) / MAP_RENDER_CHUNK_SIZE;
+    int chunkIndex = (tilePos.y / MAP_RENDER_CHUNK_SIZE) * chunksPerRow + (tilePos.x / MAP_RENDER_CHUNK_SIZE);
+    if( chunkIndex < 0 || chunkIndex >= m_TileRenderChunks.size() ) { return; }
+
+    m_TileRenderChunks[ chunkIndex ].isDirty = true;
+}
+
+//-----------------------------------------------------------------------------
+void Map::UpdateTileRenderChunk( TileRenderChunk& chunk ) const
+{
+    if( chunk.isDirty )
+    {
+        RebuildTileRenderChunk( chunk );
+    }
+}
+
+//-----------------------------------------------------------------------------
+void Map::RebuildTileRenderChunk( TileRenderChunk& chunk ) const
+{
+    chunk.isDirty = false;
+    chunk.vertices.clear();
+    for( int tileY = chunk.minTile.y; tileY <= chunk.maxTile.y; ++tileY )
+    {
+        for( int tileX = chunk.minTile.x; tileX <= chunk.maxTile.x; ++tileX )
+        {
+            AppendTileRenderToVector( chunk.vertices, m_Tiles[ tileY * m_Size.x + tileX ] );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void Map::AppendTileRenderToVector( std::vector<VertexMaster>& vector, const Tile& tile ) const
+{
+    AABB2 tileBounds = AABB2::MakeFromUnitBoxAround( static_cast<Vec2>(tile.GetTilePosition()) );
+    if( tile.GetTileType() != TILE_INVALID )
+    {
+        // If fog is off, render tiles
+        if( g_NoFog )
+        {
+            AppendTileToVectorPCU( vector, tile, false );
+        }
+            // If tile is seen
+        else if( tile.IsSeen() )
+        {
+            AppendTileToVectorPCU( vector, tile );
+        }
+        else if( !tile.IsSeen() )
+        {
+            AppendTileDefToVectorPCU( vector,
+                                      tileBounds,
+                                      TileDefinition::DEFINITIONS[ TILE_FOG ]
+                                    );
+        }
+        else
+        {
+            AppendAABB2( vector, tileBounds, Rgba8::MAGENTA );
+        }
+    }
+    else
+    {
+        AppendAABB2( vector, tileBounds, Rgba8::MAGENTA );
+    }
 }
 
 void Map::AppendTileToVectorPCU( std::vector<VertexMaster>& vector,
                                  const Tile& currentTile,
                                  bool shadeUnseenTiles ) const
 {
-    TileDefinition tileDef = currentTile.GetTileDefinition();
+    const TileDefinition& tileDef = currentTile.GetTileDefinition();
     Vec2 minUV = Vec2::ZERO;
     Vec2 maxUV = Vec2::ZERO;
     tileDef.GetSpriteSheet()->GetSpriteUVs( tileDef.GetTileSpriteIndex(), minUV, maxUV );
@@ -538,8 +1455,9 @@ void Map::AppendTileDefToVectorPCU( std::vector<VertexMaster>& vector,
                );
 }
 
-void Map::RenderEntities() const
+void Map::RenderEntities( const AABB2& cullBounds ) const
 {
+    m_NumEntitiesCulled = 0;
     for( int entityListIndex = 0; entityListIndex < NUM_ENTITY_TYPES; ++entityListIndex )
     {
         const EntityList& currentEntityList = m_EntityListsByType[ entityListIndex ];
@@ -547,18 +1465,25 @@ void Map::RenderEntities() const
         for( int entityIndex = 0; entityIndex < currentEntityList.data.size(); ++entityIndex )
         {
             const Entity* const& currentEntity = currentEntityList.data.at( entityIndex );
-            if( currentEntity != nullptr )
+            Vec2 entityPosition = static_cast<const Vec2>(currentEntity->GetPosition());
+            float cosmeticRadius = currentEntity->GetCosmeticRadius();
+            if( entityPosition.x + cosmeticRadius < cullBounds.mins.x ||
+                entityPosition.y + cosmeticRadius < cullBounds.mins.y ||
+                entityPosition.x - cosmeticRadius > cullBounds.maxes.x ||
+                entityPosition.y - cosmeticRadius > cullBounds.maxes.y )
             {
-                // Check if entity is in seen tile
-                IntVec2 tilePos = GetTilePositionFromWorldCoords( static_cast<const Vec2>(currentEntity->GetPosition())
-                                                                );
-                if( IsValidTilePos( tilePos ) )
+                ++m_NumEntitiesCulled;
+                continue;
+            }
+
+            // Check if entity is in seen tile
+            IntVec2 tilePos = GetTilePositionFromWorldCoords( entityPosition );
+            if( IsValidTilePos( tilePos ) )
+            {
+                const Tile& tile = m_Tiles.at( GetTileIndexFromPosition( tilePos ) );
+                if( g_NoFog || tile.IsSeen() && tile.IsTileCurrentSeen() )
                 {
-                    const Tile& tile = m_Tiles.at( GetTileIndexFromPosition( tilePos ) );
-                    if( g_NoFog || tile.IsSeen() && tile.IsTileCurrentSeen() )
-                    {
-                        currentEntity->Render();
-                    }
+                    currentEntity->Render();
                 }
             }
         }
@@ -576,10 +1501,7 @@ void Map::DebugRenderEntities() const
         for( int entityIndex = 0; entityIndex < currentEntityList.data.size(); ++entityIndex )
         {
             const Entity* const& currentEntity = currentEntityList.data.at( entityIndex );
-            if( currentEntity != nullptr )
-            {
-                currentEntity->DebugRender();
-            }
+            currentEntity->DebugRender();
         }
     }
 
@@ -588,13 +1510,30 @@ void Map::DebugRenderEntities() const
     for( int entityIndex = 0; entityIndex < currentEntityList.data.size(); ++entityIndex )
     {
         const Entity* const& currentEntity = currentEntityList.data.at( entityIndex );
-        if( currentEntity != nullptr )
-        {
-            currentEntity->DebugRender();
-        }
+        currentEntity->DebugRender();
     }
 }
 
+//-----------------------------------------------------------------------------
+// Arena entities are dropped with the arena and never have their destructors
+// run. Being polymorphic they can't be trivially destructible, so instead only
+// the types checked to own nothing outside the arena are allowed in. Debris,
+// for one, holds a vertex vector and must stay pooled.
+template<typename ENTITY_TYPE>
+constexpr bool IsArenaEntityType()
+{
+    return std::is_same<ENTITY_TYPE, TankNPC>::value ||
+           std::is_same<ENTITY_TYPE, TurretNPC>::value ||
+           std::is_same<ENTITY_TYPE, Bolder>::value;
+}
+
+template<typename ENTITY_TYPE, typename... ARGS>
+static Entity* NewArenaEntity( MapArena& arena, ARGS&&... args )
+{
+    static_assert( IsArenaEntityType<ENTITY_TYPE>(), "Entity type not checked for arena allocation" );
+    return arena.New<ENTITY_TYPE>( std::forward<ARGS>( args )... );
+}
+
 Entity* Map::SpawnEntityOfType( EntityType type, const Vec2& spawnPosition )
 {
     Vec3 spawnLoc = static_cast<Vec3>(spawnPosition);
@@ -604,16 +1543,16 @@ Entity* Map::SpawnEntityOfType( EntityType type, const Vec2& spawnPosition )
 
         case ENTITY_PLAYER: return new PlayerCharacter( m_GameInstance, this, spawnLoc );
 
-        case ENTITY_ALLIED_TANK: return new TankNPC( m_GameInstance, this, spawnLoc, type, FACTION_PLAYER );
-        case ENTITY_ENEMY_TANK: return new TankNPC( m_GameInstance, this, spawnLoc, type, FACTION_ENEMY );
+        case ENTITY_ALLIED_TANK: return NewArenaEntity<TankNPC>( m_Arena, m_GameInstance, this, spawnLoc, type, FACTION_PLAYER );
+        case ENTITY_ENEMY_TANK: return NewArenaEntity<TankNPC>( m_Arena, m_GameInstance, this, spawnLoc, type, FACTION_ENEMY );
 
-        case ENTITY_ALLIED_TURRET: return new TurretNPC( m_GameInstance, this, spawnLoc, type, FACTION_PLAYER );
-        case ENTITY_ENEMY_TURRET: return new TurretNPC( m_GameInstance, this, spawnLoc, type, FACTION_ENEMY );
+        case ENTITY_ALLIED_TURRET: return NewArenaEntity<TurretNPC>( m_Arena, m_GameInstance, this, spawnLoc, type, FACTION_PLAYER );
+        case ENTITY_ENEMY_TURRET: return NewArenaEntity<TurretNPC>( m_Arena, m_GameInstance, this, spawnLoc, type, FACTION_ENEMY );
 
-        case ENTITY_BULLET_ALLIED: return new Bullet( m_GameInstance, this, spawnLoc, type, FACTION_PLAYER );
-        case ENTITY_BULLET_ENEMY: return new Bullet( m_GameInstance, this, spawnLoc, type, FACTION_ENEMY );
+        case ENTITY_BULLET_ALLIED: return AcquireBullet( spawnLoc, type, FACTION_PLAYER );
+        case ENTITY_BULLET_ENEMY: return AcquireBullet( spawnLoc, type, FACTION_ENEMY );
 
-        case ENTITY_BOLDER: return new Bolder( m_GameInstance, this, spawnLoc );
+        case ENTITY_BOLDER: return NewArenaEntity<Bolder>( m_Arena, m_GameInstance, this, spawnLoc );
 
         case ENTITY_EXPLOSION: ERROR_AND_DIE( "Spawn Explosion from specific explosion function" );
 
@@ -624,23 +1563,145 @@ Entity* Map::SpawnEntityOfType( EntityType type, const Vec2& spawnPosition )
 
 void Map::AddEntityToMap( EntityType type, Entity* entity )
 {
-    m_EntityListsByType[ type ].RapidReplace( entity );
+    if( type != ENTITY_PLAYER && IsHeapEntity( entity ) ) { ++m_NumHeapEntities; }
+    entity->SetHandle( m_EntityHandles.Add( entity ) );
+    m_EntityListsByType[ type ].Add( entity );
+}
+
+// Pooled entities give up their kinematics slots until they are acquired,
+// the slots they leave behind keep the kinematics arrays at full size
+void Map::PrewarmEntityPools()
+{
+    Vec3 poolPosition = Vec3::ZERO;
+    m_BulletPool.Prewarm( MAP_BULLET_POOL_SIZE, [&]( void* block ) {
+        Bullet* bullet = new(block) Bullet( m_GameInstance, this, poolPosition, ENTITY_BULLET_ALLIED, FACTION_PLAYER );
+        bullet->ReleaseKinematics();
+    } );
+    m_ExplosionPool.Prewarm( MAP_EXPLOSION_POOL_SIZE, [&]( void* block ) {
+        Explosion* explosion = new(block) Explosion( m_GameInstance, this, poolPosition, 1.f, Vec3::ONE );
+        explosion->ReleaseKinematics();
+    } );
+    m_DebrisPool.Prewarm( MAP_DEBRIS_POOL_SIZE, [&]( void* block ) {
+        Debris* debris = new(block) Debris( m_GameInstance, this, poolPosition, Vec3::ZERO, 0.f, 1.f, 1.f,
+                                            Rgba8::WHITE, true, nullptr, 4, .5f, 1.f );
+        debris->ReleaseKinematics();
+    } );
+
+    // Lists hold every pooled entity at once without growing mid combat
+    m_EntityListsByType[ ENTITY_BULLET_ALLIED ].data.reserve( MAP_BULLET_POOL_SIZE );
+    m_EntityListsByType[ ENTITY_BULLET_ENEMY ].data.reserve( MAP_BULLET_POOL_SIZE );
+    m_EntityListsByType[ ENTITY_EXPLOSION ].data.reserve( MAP_EXPLOSION_POOL_SIZE );
+    m_EntityListsByType[ ENTITY_DEBRIS ].data.reserve( MAP_DEBRIS_POOL_SIZE );
+}
+
+void Map::ApplyCommands()
+{
+    m_CommandBuffer.Flush( [this]( const MapCommand& command ) {
+        switch( command.type )
+        {
+            case MapCommandType::SPAWN_BULLET:
+            {
+                Bullet* bullet = static_cast<Bullet*>(SpawnNewEntity( command.entityType, static_cast<Vec2>(command.position) ));
+                bullet->SetBulletDireciton( command.direction );
+                break;
+            }
+            case MapCommandType::SPAWN_EXPLOSION:
+                SpawnNewExplosion( command.position, command.duration, command.scale );
+                break;
+            default:
+                ERROR_AND_DIE( Stringf( "Unhandled map command %i", static_cast<int>(command.type) ) );
+        }
+    } );
+}
+
+Bullet* Map::AcquireBullet( const Vec3& spawnPosition, EntityType type, Faction faction )
+{
+    Bullet* bullet = m_BulletPool.Acquire();
+    if( bullet == nullptr )
+    {
+        return new Bullet( m_GameInstance, this, spawnPosition, type, faction );
+    }
+
+    bullet->Reuse( spawnPosition, type, faction );
+    return bullet;
+}
+
+//-----------------------------------------------------------------------------
+const char* GetCollisionBroadphaseName( CollisionBroadphase broadphase )
+{
+    switch( broadphase )
+    {
+        case CollisionBroadphase::BRUTE_FORCE:      return "brute force";
+        case CollisionBroadphase::GRID:             return "grid";
+        case CollisionBroadphase::SWEEP_AND_PRUNE:  return "sweep and prune";
+        default:                                    return "unknown";
+    }
+}
+
+void Map::SetCollisionBroadphase( CollisionBroadphase broadphase )
+{
+    m_CollisionBroadphase = broadphase;
 }
 
 void Map::HandleMapCollisions()
 {
+    SweepEntitiesAgainstTiles();
+
+    // Island and solver paths need every pair before resolving any of them
+    bool gathersPairsUpFront = g_ParallelCollisions || m_ContactSolverMode != ContactSolverMode::PAIRWISE;
+    if( gathersPairsUpFront )
+    {
+        HandleGatheredEntityCollisions();
+    }
+    else
+    {
+        switch( m_CollisionBroadphase )
+        {
+            case CollisionBroadphase::GRID:
+                m_EntityGrid.Rebuild( m_EntityListsByType, NUM_ENTITY_TYPES, m_Size );
+                break;
+            case CollisionBroadphase::SWEEP_AND_PRUNE:
+                m_SweepAndPrune.Update( m_EntityListsByType, NUM_ENTITY_TYPES );
+                m_BroadphasePairs.clear();
+                m_SweepAndPrune.GetPairs( m_BroadphasePairs );
+                SortBroadphasePairsByList( m_BroadphasePairs );
+                m_NextBroadphasePair = 0;
+                break;
+            default:
+                break;
+        }
+    }
+
     for( int entityListIndex1 = 0; entityListIndex1 < NUM_ENTITY_TYPES; ++entityListIndex1 )
     {
-        for( int entityListIndex2 = entityListIndex1; entityListIndex2 < NUM_ENTITY_TYPES; ++entityListIndex2 )
+        if( !gathersPairsUpFront )
         {
-            HandleListVsListOverlaps( entityListIndex1,
-                                      entityListIndex2
-                                    );
+            switch( m_CollisionBroadphase )
+            {
+                case CollisionBroadphase::BRUTE_FORCE:
+                    for( int entityListIndex2 = entityListIndex1; entityListIndex2 < NUM_ENTITY_TYPES; ++entityListIndex2 )
+                    {
+                        HandleListVsListOverlaps( entityListIndex1,
+                                                  entityListIndex2
+                                                );
+                    }
+                    break;
+                case CollisionBroadphase::GRID:
+                    HandleListVsNearbyOverlaps( entityListIndex1 );
+                    break;
+                case CollisionBroadphase::SWEEP_AND_PRUNE:
+                    HandleListVsBroadphasePairs( entityListIndex1 );
+                    break;
+                default:
+                    break;
+            }
         }
 
         HandleListVsTileOverlaps( entityListIndex1 );
     }
 
+    KillSweptWallHits();
+
     Entity* playerCharacter = (Entity*)m_World->GetPlayerCharacter();
     Disc playerDisc = playerCharacter->GetEntityPhysicsDisc();
     Vec2 exitCenter = GetTileFromPosition( m_ExitLocation )->GetTileBoundingBox().GetCenter();
@@ -651,6 +1712,46 @@ void Map::HandleMapCollisions()
     }
 }
 
+//-----------------------------------------------------------------------------
+// Moves each swept entity back to where its path first touches a projectile
+// blocking tile, so fast bullets can't step over thin walls
+void Map::SweepEntitiesAgainstTiles()
+{
+    m_SweptWallHits.clear();
+
+    for( int entityListIndex = 0; entityListIndex < NUM_ENTITY_TYPES; ++entityListIndex )
+    {
+        EntityList& entityList = m_EntityListsByType[ entityListIndex ];
+        for( int entityIndex = 0; entityIndex < entityList.data.size(); ++entityIndex )
+        {
+            Entity* entity = entityList.data.at( entityIndex );
+            if( entity->IsDead() || entity->IsGarbage() ) { continue; }
+            if( !entity->UsesSweptCollision() || !Entity::OverlapsWithTiles( entity ) ) { continue; }
+
+            Vec2 start = static_cast<Vec2>(entity->GetPreviousPosition());
+            Vec2 end = static_cast<Vec2>(entity->GetPosition());
+            float hitTime = 0.f;
+            if( SweepDiscVsTiles( m_ProjectileBlockingTiles, start, end, entity->GetPhysicsRadius(), hitTime ) )
+            {
+                entity->SetPosition( static_cast<Vec3>(start + (end - start) * hitTime) );
+                m_SweptWallHits.push_back( entity );
+            }
+        }
+    }
+}
+
+void Map::KillSweptWallHits()
+{
+    for( int hitIndex = 0; hitIndex < m_SweptWallHits.size(); ++hitIndex )
+    {
+        Entity* entity = m_SweptWallHits[ hitIndex ];
+        if( entity->IsDead() || entity->IsGarbage() ) { continue; }
+
+        entity->Die();
+    }
+    m_SweptWallHits.clear();
+}
+
 void Map::HandleListVsListOverlaps( EntityListIndex l1, EntityListIndex l2 )
 {
     if( !Entity::DoEntityListsOverlap( l1, l2 ) ) { return; }
@@ -669,30 +1770,346 @@ void Map::HandleListVsListOverlaps( EntityListIndex l1, EntityListIndex l2 )
     }
 }
 
-void Map::HandleEntityVsEntityOverlaps( Entity*& entity1, Entity*& entity2 )
+//-----------------------------------------------------------------------------
+// Same pairs as HandleListVsListOverlaps against every later list, but only
+// for entities in neighboring grid cells
+void Map::HandleListVsNearbyOverlaps( EntityListIndex l1 )
 {
-    if( entity1 == nullptr || entity2 == nullptr ) { return; }
-    if( entity1->IsDead() || entity1->IsGarbage() ) { return; }
-    if( entity2->IsDead() || entity2->IsGarbage() ) { return; }
+    EntityList& list1 = m_EntityListsByType[ l1 ];
+    for( int entityIndex1 = 0; entityIndex1 < list1.data.size(); ++entityIndex1 )
+    {
+        const Entity* entity1 = list1.data.at( entityIndex1 );
+
+        m_NearbyEntities.clear();
+        GetGridEntriesNearEntity( m_EntityGrid, entity1, m_NearbyEntities );
+        for( int nearbyIndex = 0; nearbyIndex < m_NearbyEntities.size(); ++nearbyIndex )
+        {
+            const EntityGridEntry& nearby = m_NearbyEntities[ nearbyIndex ];
+            Entity*& entity2 = m_EntityListsByType[ nearby.listIndex ].data.at( nearby.entityIndex );
+            if( !IsGridPairOwnedBy( l1, entity1, nearby.listIndex, entity2 ) ) { continue; }
+            if( !Entity::DoEntityListsOverlap( l1, nearby.listIndex ) ) { continue; }
 
-    // Check non colliding entities
-    switch( Entity::OverlapsWith( entity1, entity2 ) )
+            HandleEntityVsEntityOverlaps( list1.data.at( entityIndex1 ), entity2 );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Pairs are sorted by their first list, so each list takes the next run
+void Map::HandleListVsBroadphasePairs( EntityListIndex l1 )
+{
+    for( ; m_NextBroadphasePair < m_BroadphasePairs.size(); ++m_NextBroadphasePair )
     {
-        case EntityOverlapType::NONE: return;
-        case EntityOverlapType::OVERLAP_ONLY: HandleOverlapOnly( entity1, entity2 );
+        const EntityGridPair& pair = m_BroadphasePairs[ m_NextBroadphasePair ];
+        if( pair.first.listIndex != l1 ) { return; }
+        if( !Entity::DoEntityListsOverlap( pair.first.listIndex, pair.second.listIndex ) ) { continue; }
+
+        HandleEntityVsEntityOverlaps( m_EntityListsByType[ pair.first.listIndex ].data.at( pair.first.entityIndex ),
+                                      m_EntityListsByType[ pair.second.listIndex ].data.at( pair.second.entityIndex )
+                                    );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Every candidate pair from the current backend, each unordered pair once
+void Map::GatherBroadphasePairs()
+{
+    m_BroadphasePairs.clear();
+
+    EntityGridPair pair;
+    switch( m_CollisionBroadphase )
+    {
+        case CollisionBroadphase::BRUTE_FORCE:
+            for( int listIndex1 = 0; listIndex1 < NUM_ENTITY_TYPES; ++listIndex1 )
+            {
+                const EntityList& list1 = m_EntityListsByType[ listIndex1 ];
+                for( int listIndex2 = listIndex1; listIndex2 < NUM_ENTITY_TYPES; ++listIndex2 )
+                {
+                    if( !Entity::DoEntityListsOverlap( listIndex1, listIndex2 ) ) { continue; }
+
+                    const EntityList& list2 = m_EntityListsByType[ listIndex2 ];
+                    for( int entityIndex1 = 0; entityIndex1 < list1.data.size(); ++entityIndex1 )
+                    {
+                        int firstEntityIndex2 = listIndex1 == listIndex2 ? entityIndex1 + 1 : 0;
+                        for( int entityIndex2 = firstEntityIndex2; entityIndex2 < list2.data.size(); ++entityIndex2 )
+                        {
+                            pair.first.listIndex = listIndex1;
+                            pair.first.entityIndex = entityIndex1;
+                            pair.second.listIndex = listIndex2;
+                            pair.second.entityIndex = entityIndex2;
+                            m_BroadphasePairs.push_back( pair );
+                        }
+                    }
+                }
+            }
             break;
-        case EntityOverlapType::PUSH_PUSH: HandlePushedVsPushed( entity1, entity2 );
+        case CollisionBroadphase::GRID:
+            m_EntityGrid.Rebuild( m_EntityListsByType, NUM_ENTITY_TYPES, m_Size );
+            for( int listIndex1 = 0; listIndex1 < NUM_ENTITY_TYPES; ++listIndex1 )
+            {
+                const EntityList& list1 = m_EntityListsByType[ listIndex1 ];
+                for( int entityIndex1 = 0; entityIndex1 < list1.data.size(); ++entityIndex1 )
+                {
+                    const Entity* entity1 = list1.data[ entityIndex1 ];
+
+                    m_NearbyEntities.clear();
+                    GetGridEntriesNearEntity( m_EntityGrid, entity1, m_NearbyEntities );
+                    for( int nearbyIndex = 0; nearbyIndex < m_NearbyEntities.size(); ++nearbyIndex )
+                    {
+                        const EntityGridEntry& nearby = m_NearbyEntities[ nearbyIndex ];
+                        const Entity* entity2 = m_EntityListsByType[ nearby.listIndex ].data[ nearby.entityIndex ];
+                        if( !IsGridPairOwnedBy( listIndex1, entity1, nearby.listIndex, entity2 ) ) { continue; }
+                        if( !Entity::DoEntityListsOverlap( listIndex1, nearby.listIndex ) ) { continue; }
+                        if( nearby.listIndex == listIndex1 && nearby.entityIndex <= entityIndex1 ) { continue; }
+
+                        pair.first.listIndex = listIndex1;
+                        pair.first.entityIndex = entityIndex1;
+                        pair.second = nearby;
+                        m_BroadphasePairs.push_back( pair );
+                    }
+                }
+            }
             break;
-        case EntityOverlapType::PUSH_FIXED: DeterminePushedVsFixedEntity( entity1, entity2 );
+        case CollisionBroadphase::SWEEP_AND_PRUNE:
+            m_SweepAndPrune.Update( m_EntityListsByType, NUM_ENTITY_TYPES );
+            m_SweepAndPrune.GetPairs( m_BroadphasePairs );
             break;
-        case EntityOverlapType::PUSH_NO_PUSH: break;
-        case EntityOverlapType::FIXED_NO_PUSH: break;
         default:
-            ERROR_AND_DIE( "Collision type not handled" );
             break;
     }
 }
 
+//-----------------------------------------------------------------------------
+// Push pairs are resolved first, by the contact solver or split into islands.
+// Bullet pairs spawn explosions and damage entities, so they run after on
+// this thread.
+//
+// Pairs are gathered in the order the sequential path visits them, and
+// islands only reorder pairs that share no moving entity, so with the
+// pairwise solver push pairs resolve the same as on the sequential path. Bullet pairs are where the two
+// diverge: here every one runs before any tile push out, while the
+// sequential path runs each with the list that owns it, after the tile push
+// out of earlier lists. A bullet can see an entity a wall has not pushed
+// back yet.
+void Map::HandleGatheredEntityCollisions()
+{
+    GatherBroadphasePairs();
+
+    m_PushPairs.clear();
+    for( int pairIndex = 0; pairIndex < m_BroadphasePairs.size(); ++pairIndex )
+    {
+        const EntityGridPair& pair = m_BroadphasePairs[ pairIndex ];
+        const Entity* entity1 = m_EntityListsByType[ pair.first.listIndex ].data[ pair.first.entityIndex ];
+        const Entity* entity2 = m_EntityListsByType[ pair.second.listIndex ].data[ pair.second.entityIndex ];
+        EntityOverlapType overlapType = Entity::OverlapsWith( entity1, entity2 );
+        if( overlapType == EntityOverlapType::PUSH_PUSH || overlapType == EntityOverlapType::PUSH_FIXED )
+        {
+            m_PushPairs.push_back( pair );
+        }
+    }
+
+    if( m_ContactSolverMode == ContactSolverMode::PAIRWISE )
+    {
+        HandleEntityCollisionsInIslands();
+    }
+    else
+    {
+        SolvePushPairs();
+    }
+
+    for( int pairIndex = 0; pairIndex < m_BroadphasePairs.size(); ++pairIndex )
+    {
+        const EntityGridPair& pair = m_BroadphasePairs[ pairIndex ];
+        Entity*& entity1 = m_EntityListsByType[ pair.first.listIndex ].data.at( pair.first.entityIndex );
+        Entity*& entity2 = m_EntityListsByType[ pair.second.listIndex ].data.at( pair.second.entityIndex );
+        if( Entity::OverlapsWith( entity1, entity2 ) != EntityOverlapType::OVERLAP_ONLY ) { continue; }
+
+        HandleEntityVsEntityOverlaps( entity1, entity2 );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Islands resolve across the game's thread pool, each island's contacts are
+// recorded in island order once all of them finish
+void Map::HandleEntityCollisionsInIslands()
+{
+    m_CollisionIslands.Build( m_EntityListsByType, NUM_ENTITY_TYPES, m_PushPairs );
+    int numIslands = m_CollisionIslands.GetNumIslands();
+    if( m_IslandContacts.size() < numIslands )
+    {
+        m_IslandContacts.resize( numIslands );
+    }
+
+    auto resolveIsland = [this]( int islandIndex )
+    {
+        m_IslandContacts[ islandIndex ].clear();
+        ResolveCollisionIsland( islandIndex, m_IslandContacts[ islandIndex ] );
+    };
+
+    ThreadPool* threadPool = m_GameInstance->GetThreadPool();
+    if( threadPool != nullptr && m_PushPairs.size() >= MAP_PARALLEL_COLLISION_MIN_PAIRS )
+    {
+        threadPool->ParallelFor( numIslands, resolveIsland );
+    }
+    else
+    {
+        for( int islandIndex = 0; islandIndex < numIslands; ++islandIndex )
+        {
+            resolveIsland( islandIndex );
+        }
+    }
+
+    for( int islandIndex = 0; islandIndex < numIslands; ++islandIndex )
+    {
+        const std::vector<EntityContact>& islandContacts = m_IslandContacts[ islandIndex ];
+        for( int contactIndex = 0; contactIndex < islandContacts.size(); ++contactIndex )
+        {
+            RecordEntityContact( islandContacts[ contactIndex ] );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Every push pair goes to the solver, so discs pushed into a third disc are
+// pushed again in the same frame. Contacts are recorded for pairs that
+// overlapped before solving, same as the pairwise path.
+void Map::SolvePushPairs()
+{
+    m_SolverListSlotStarts.resize( NUM_ENTITY_TYPES + 1 );
+    m_SolverListSlotStarts[ 0 ] = 0;
+    for( int listIndex = 0; listIndex < NUM_ENTITY_TYPES; ++listIndex )
+    {
+        int listSize = static_cast<int>(m_EntityListsByType[ listIndex ].data.size());
+        m_SolverListSlotStarts[ listIndex + 1 ] = m_SolverListSlotStarts[ listIndex ] + listSize;
+    }
+    m_SolverBodyOfSlot.assign( m_SolverListSlotStarts[ NUM_ENTITY_TYPES ], -1 );
+
+    m_ContactSolver.Clear();
+    m_SolverEntities.clear();
+    m_SolverContacts.clear();
+
+    for( int pairIndex = 0; pairIndex < m_PushPairs.size(); ++pairIndex )
+    {
+        const EntityGridPair& pair = m_PushPairs[ pairIndex ];
+        Entity* entity1 = m_EntityListsByType[ pair.first.listIndex ].data[ pair.first.entityIndex ];
+        Entity* entity2 = m_EntityListsByType[ pair.second.listIndex ].data[ pair.second.entityIndex ];
+        if( entity1->IsDead() || entity1->IsGarbage() ) { continue; }
+        if( entity2->IsDead() || entity2->IsGarbage() ) { continue; }
+        if( entity1->IsFixed() && entity2->IsFixed() ) { continue; }
+
+        EntityContact contact = MakeEntityContact( entity1, entity2 );
+        if( contact.depth > 0.f )
+        {
+            m_SolverContacts.push_back( contact );
+        }
+
+        Vec2 fallbackNormal = contact.normal != Vec2::ZERO ? contact.normal : Vec2( 1.f, 0.f );
+        m_ContactSolver.AddContact( GetSolverBody( pair.first ), GetSolverBody( pair.second ), fallbackNormal );
+    }
+
+    if( m_ContactSolverMode == ContactSolverMode::JACOBI )
+    {
+        m_ContactSolver.SolveJacobi( m_GameInstance->GetThreadPool() );
+    }
+    else
+    {
+        m_ContactSolver.SolveGaussSeidel();
+    }
+
+    for( int bodyIndex = 0; bodyIndex < m_SolverEntities.size(); ++bodyIndex )
+    {
+        Entity* entity = m_SolverEntities[ bodyIndex ];
+        if( entity->IsFixed() ) { continue; }
+
+        entity->SetPosition( static_cast<Vec3>(m_ContactSolver.GetBodyPosition( bodyIndex )) );
+    }
+
+    for( int contactIndex = 0; contactIndex < m_SolverContacts.size(); ++contactIndex )
+    {
+        RecordEntityContact( m_SolverContacts[ contactIndex ] );
+    }
+}
+
+int Map::GetSolverBody( const EntityGridEntry& entry )
+{
+    int slot = m_SolverListSlotStarts[ entry.listIndex ] + entry.entityIndex;
+    if( m_SolverBodyOfSlot[ slot ] < 0 )
+    {
+        Entity* entity = m_EntityListsByType[ entry.listIndex ].data[ entry.entityIndex ];
+        m_SolverBodyOfSlot[ slot ] = m_ContactSolver.AddBody( static_cast<Vec2>(entity->GetPosition()),
+                                                              entity->GetPhysicsRadius(),
+                                                              entity->IsFixed() );
+        m_SolverEntities.push_back( entity );
+    }
+    return m_SolverBodyOfSlot[ slot ];
+}
+
+//-----------------------------------------------------------------------------
+// Runs on worker threads. Only moves entities in this island, fixed entities
+// are read only, and contacts go to this island's own list.
+void Map::ResolveCollisionIsland( int islandIndex, std::vector<EntityContact>& out_contacts )
+{
+    const int* pairIndices = m_CollisionIslands.GetIslandPairIndices( islandIndex );
+    int numPairs = m_CollisionIslands.GetNumIslandPairs( islandIndex );
+    for( int islandPairIndex = 0; islandPairIndex < numPairs; ++islandPairIndex )
+    {
+        const EntityGridPair& pair = m_PushPairs[ pairIndices[ islandPairIndex ] ];
+        Entity* entity1 = m_EntityListsByType[ pair.first.listIndex ].data[ pair.first.entityIndex ];
+        Entity* entity2 = m_EntityListsByType[ pair.second.listIndex ].data[ pair.second.entityIndex ];
+        if( entity1->IsGarbage() || entity2->IsGarbage() ) { continue; }
+
+#if defined( _DEBUG )
+        if( (!entity1->IsFixed() && m_CollisionIslands.GetEntityIsland( pair.first ) != islandIndex) ||
+            (!entity2->IsFixed() && m_CollisionIslands.GetEntityIsland( pair.second ) != islandIndex) )
+        {
+            ERROR_AND_DIE( "Collision island would move an entity owned by another island" );
+        }
+#endif
+
+        EntityContact contact;
+        bool didResolve = false;
+        if( Entity::OverlapsWith( entity1, entity2 ) == EntityOverlapType::PUSH_PUSH )
+        {
+            didResolve = ResolvePushedVsPushed( entity1, entity2, contact );
+        }
+        else if( entity1->IsFixed() != entity2->IsFixed() )
+        {
+            didResolve = entity1->IsFixed() ? ResolvePushedVsFixed( entity2, entity1, contact )
+                                            : ResolvePushedVsFixed( entity1, entity2, contact );
+        }
+
+        if( didResolve )
+        {
+            out_contacts.push_back( contact );
+        }
+    }
+}
+
+void Map::HandleEntityVsEntityOverlaps( Entity*& entity1, Entity*& entity2 )
+{
+    if( entity1->IsDead() || entity1->IsGarbage() ) { return; }
+    if( entity2->IsDead() || entity2->IsGarbage() ) { return; }
+
+    // Indexed by EntityOverlapType
+    static const EntityOverlapHandler OVERLAP_HANDLERS[ static_cast<int>(EntityOverlapType::NUM_ENTITY_OVERLAP_TYPES) ] = {
+        &Map::HandleNoOverlap,                  // NONE
+        &Map::HandleOverlapOnly,                // OVERLAP_ONLY
+        &Map::HandlePushedVsPushed,             // PUSH_PUSH
+        &Map::HandleNoOverlap,                  // PUSH_NO_PUSH
+        &Map::DeterminePushedVsFixedEntity,     // PUSH_FIXED
+        &Map::HandleNoOverlap,                  // FIXED_NO_PUSH
+    };
+
+    EntityOverlapType overlapType = Entity::OverlapsWith( entity1, entity2 );
+    (this->*OVERLAP_HANDLERS[ static_cast<int>(overlapType) ])( entity1, entity2 );
+}
+
+void Map::HandleNoOverlap( Entity*& entity1, Entity*& entity2 )
+{
+    UNUSED( entity1 );
+    UNUSED( entity2 );
+}
+
 void Map::HandleOverlapOnly( Entity*& entity1, Entity*& entity2 )
 {
     Entity* entity = nullptr;
@@ -717,21 +2134,76 @@ void Map::HandleOverlapOnly( Entity*& entity1, Entity*& entity2 )
     HandleEntityVsBulletCollision( entity, bulletEntity );
 }
 
-void Map::HandlePushedVsPushed( Entity*& entity1, Entity*& entity2 )
+//-----------------------------------------------------------------------------
+// Made before resolving so the depth is how far the discs overlapped
+EntityContact Map::MakeEntityContact( Entity* entity1, Entity* entity2 ) const
 {
-    // Dead entities don't collide
-    if( entity1->IsDead() || entity2->IsDead() ) { return; }
-    if( DoDiscsOverlap( entity1->GetEntityPhysicsDisc(), entity2->GetEntityPhysicsDisc() ) )
+    const Disc disc1 = entity1->GetEntityPhysicsDisc();
+    const Disc disc2 = entity2->GetEntityPhysicsDisc();
+    Vec2 displacement = disc2.center - disc1.center;
+    float distance = displacement.GetLength();
+
+    EntityContact contact;
+    contact.entity1 = entity1;
+    contact.entity2 = entity2;
+    contact.depth = disc1.radius + disc2.radius - distance;
+    if( distance > 0.f )
     {
-        Disc entityDisc1 = entity1->GetEntityPhysicsDisc();
-        Disc entityDisc2 = entity2->GetEntityPhysicsDisc();
+        contact.normal = displacement / distance;
+    }
+    else
+    {
+        m_ContactCache.GetPreviousNormal( entity1, entity2, contact.normal );
+    }
+    return contact;
+}
+
+ContactEventType Map::RecordEntityContact( const EntityContact& contact )
+{
+    return m_ContactCache.RecordContact( contact.entity1, contact.entity2, contact.normal, contact.depth );
+}
+
+//-----------------------------------------------------------------------------
+// Discs sitting on top of each other have no push direction of their own,
+// so keep separating them the way they were separated last frame
+void Map::WarmStartCoincidentDiscs( const Entity* entity1, const Entity* entity2, const Disc& disc1, Disc& out_disc2 ) const
+{
+    Vec2 displacement = out_disc2.center - disc1.center;
+    if( displacement.GetLength() >= MAP_CONTACT_COINCIDENT_DIST ) { return; }
+
+    Vec2 previousNormal = Vec2::ZERO;
+    if( m_ContactCache.GetPreviousNormal( entity1, entity2, previousNormal ) )
+    {
+        out_disc2.center = disc1.center + previousNormal * MAP_CONTACT_COINCIDENT_DIST;
+    }
+}
 
-        Disc::PushDiscMobileOutOfDiscMobile( entityDisc1, entityDisc2 );
-        entity2->SetPosition( static_cast<Vec3>(entityDisc2.center) );
-        entity1->SetPosition( static_cast<Vec3>(entityDisc1.center) );
+void Map::HandlePushedVsPushed( Entity*& entity1, Entity*& entity2 )
+{
+    EntityContact contact;
+    if( ResolvePushedVsPushed( entity1, entity2, contact ) )
+    {
+        RecordEntityContact( contact );
     }
 }
 
+bool Map::ResolvePushedVsPushed( Entity* entity1, Entity* entity2, EntityContact& out_contact )
+{
+    // Dead entities don't collide
+    if( entity1->IsDead() || entity2->IsDead() ) { return false; }
+    if( !DoDiscsOverlap( entity1->GetEntityPhysicsDisc(), entity2->GetEntityPhysicsDisc() ) ) { return false; }
+
+    Disc entityDisc1 = entity1->GetEntityPhysicsDisc();
+    Disc entityDisc2 = entity2->GetEntityPhysicsDisc();
+
+    WarmStartCoincidentDiscs( entity1, entity2, entityDisc1, entityDisc2 );
+    out_contact = MakeEntityContact( entity1, entity2 );
+    Disc::PushDiscMobileOutOfDiscMobile( entityDisc1, entityDisc2 );
+    entity2->SetPosition( static_cast<Vec3>(entityDisc2.center) );
+    entity1->SetPosition( static_cast<Vec3>(entityDisc1.center) );
+    return true;
+}
+
 void Map::DeterminePushedVsFixedEntity( Entity*& entity1, Entity*& entity2 )
 {
     Entity* pushed = nullptr;
@@ -752,42 +2224,84 @@ void Map::DeterminePushedVsFixedEntity( Entity*& entity1, Entity*& entity2 )
     HandlePushedVsFixed( pushed, fixed );
 }
 
-void Map::HandlePushedVsFixed( Entity*& pushed, const Entity* fixed )
+void Map::HandlePushedVsFixed( Entity*& pushed, Entity* fixed )
 {
-    // Dead entities don't collide
-    if( pushed->IsDead() || fixed->IsDead() ) { return; }
-    if( DoDiscsOverlap( pushed->GetEntityPhysicsDisc(), fixed->GetEntityPhysicsDisc() ) )
+    EntityContact contact;
+    if( ResolvePushedVsFixed( pushed, fixed, contact ) )
     {
-        Disc pushedDisc = pushed->GetEntityPhysicsDisc();
-        const Disc fixedDisc = fixed->GetEntityPhysicsDisc();
-
-        Disc::PushDiscMobileOutOfDiscFixed( pushedDisc, fixedDisc );
-        pushed->SetPosition( static_cast<Vec3>(pushedDisc.center) );
+        RecordEntityContact( contact );
     }
 }
 
+bool Map::ResolvePushedVsFixed( Entity* pushed, Entity* fixed, EntityContact& out_contact )
+{
+    // Dead entities don't collide
+    if( pushed->IsDead() || fixed->IsDead() ) { return false; }
+    if( !DoDiscsOverlap( pushed->GetEntityPhysicsDisc(), fixed->GetEntityPhysicsDisc() ) ) { return false; }
+
+    Disc pushedDisc = pushed->GetEntityPhysicsDisc();
+    const Disc fixedDisc = fixed->GetEntityPhysicsDisc();
+
+    WarmStartCoincidentDiscs( fixed, pushed, fixedDisc, pushedDisc );
+    out_contact = MakeEntityContact( pushed, fixed );
+    Disc::PushDiscMobileOutOfDiscFixed( pushedDisc, fixedDisc );
+    pushed->SetPosition( static_cast<Vec3>(pushedDisc.center) );
+    return true;
+}
+
 void Map::HandleEntityVsBulletCollision( Entity*& entity, Bullet*& bullet )
 {
     // Bullets do not collide with the same faction entities
     if( entity->GetEntityFaction() == bullet->GetEntityFaction() ) { return; }
 
+    // Sweep the bullet over its move this frame, treating the entity as still
     const Disc& entityDisc = entity->GetEntityPhysicsDisc();
-    const Disc& buttleDisc = bullet->GetEntityPhysicsDisc();
+    Vec2 bulletStart = static_cast<Vec2>(bullet->GetPreviousPosition());
+    Vec2 bulletEnd = static_cast<Vec2>(bullet->GetPosition());
+    float hitTime = 0.f;
 
-    if( DoDiscsOverlap( entityDisc, buttleDisc ) )
+    if( SweepDiscVsDisc( bulletStart, bulletEnd, bullet->GetPhysicsRadius(), entityDisc.center, entityDisc.radius, hitTime ) )
     {
+        // A bullet that started the frame overlapping stays put, it may be
+        // leaving a bolder it just bounced off
+        if( hitTime > 0.f )
+        {
+            bullet->SetPosition( static_cast<Vec3>(bulletStart + (bulletEnd - bulletStart) * hitTime) );
+        }
+
+        // HandleBulletContactEvents reacts to the hit
+        RecordEntityContact( MakeEntityContact( entity, bullet ) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Runs before EndFrame, so a bullet killed here has its contacts ended
+// before it is deleted. A hit lands when the contact begins. A bolder
+// re-tests the bounce on every stay frame too, since a bolder pushed onto
+// a bullet may only face it a frame or two later.
+void Map::HandleBulletContactEvents()
+{
+    const std::vector<ContactEvent>& events = m_ContactCache.GetEvents();
+    for( int eventIndex = 0; eventIndex < events.size(); ++eventIndex )
+    {
+        const ContactEvent& event = events[ eventIndex ];
+        if( event.type == ContactEventType::END ) { continue; }
+        if( !IsBulletEntityType( event.entity2->GetEntityType() ) ) { continue; }
+
+        Entity* entity = event.entity1;
+        Bullet* bullet = static_cast<Bullet*>(event.entity2);
         if( entity->GetEntityType() == ENTITY_BOLDER )
         {
+            // The contact normal points from the bolder out to the bullet
             Vec3 reflectedVelocity = bullet->GetVelocity();
-            Vec3 hitNormal = entity->GetPhysicsDiscNormalAt( bullet->GetPosition() );
-
+            Vec3 hitNormal = static_cast<Vec3>(-event.normal);
             if( Vec3::Dot( reflectedVelocity, hitNormal ) > 0 )
             {
                 reflectedVelocity.ReflectAcrossNormal( hitNormal );
                 bullet->SetVelocity( reflectedVelocity );
             }
         }
-        else
+        else if( event.type == ContactEventType::BEGIN )
         {
             entity->DamageEntity( 1 );
             bullet->Die();
@@ -799,39 +2313,81 @@ void Map::HandleListVsTileOverlaps( EntityListIndex l1 )
 {
     EntityList& list1 = m_EntityListsByType[ l1 ];
 
+    m_WallPushEntities.clear();
+    m_WallPushCenters.clear();
+    m_WallPushRadii.clear();
+    m_WallPushTiles.clear();
+    m_WallPushMasks.clear();
+
     // Entity Interactions with Tiles
     for( int entityIndex = 0; entityIndex < list1.data.size(); ++entityIndex )
     {
         Entity*& currentEntity = list1.data.at( entityIndex );
-        if( currentEntity == nullptr ) { continue; }
         if( currentEntity->IsDead() || currentEntity->IsGarbage() ) { continue; }
+        // Already handled over its whole path in SweepEntitiesAgainstTiles
+        if( currentEntity->UsesSweptCollision() ) { continue; }
 
         if( Entity::OverlapsWithTiles( currentEntity ) )
         {
             if( currentEntity->GetEntityType() == ENTITY_PLAYER && g_NoClip ) { continue; }
 
-            static IntVec2 bottomCenter = IntVec2( 0, -1 );
-            static IntVec2 rightCenter = IntVec2( 1, 0 );
-            static IntVec2 topCenter = IntVec2( 0, 1 );
-            static IntVec2 leftCenter = IntVec2( -1, 0 );
-            static IntVec2 bottomLeft = IntVec2( -1, -1 );
-            static IntVec2 bottomRight = IntVec2( -1, 1 );
-            static IntVec2 topRight = IntVec2( 1, 1 );
-            static IntVec2 topLeft = IntVec2( 1, -1 );
             IntVec2 entityTilePosition = GetTilePositionFromWorldCoords(
                                                                         static_cast<Vec2>(currentEntity->GetPosition())
                                                                        );
 
             HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + bottomCenter ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + rightCenter ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + topCenter ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + leftCenter ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + bottomLeft ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + bottomRight ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + topRight ) );
-            HandleEntityVsTileOverlap( currentEntity, GetTileFromPosition( entityTilePosition + topLeft ) );
+            if( !currentEntity->IsPushedByWalls() )
+            {
+                HandleEntityVsNeighborTileOverlaps( currentEntity, entityTilePosition );
+                continue;
+            }
+
+            m_WallPushEntities.push_back( currentEntity );
+            m_WallPushCenters.push_back( static_cast<Vec2>(currentEntity->GetPosition()) );
+            m_WallPushRadii.push_back( currentEntity->GetPhysicsRadius() );
+            m_WallPushTiles.push_back( entityTilePosition );
+            m_WallPushMasks.push_back( m_SolidNeighborMasks.GetMask( entityTilePosition ) );
+        }
+    }
+
+    if( m_WallPushEntities.empty() ) { return; }
+
+    PushDiscsOutOfNeighborTiles( m_WallPushCenters.data(),
+                                 m_WallPushRadii.data(),
+                                 m_WallPushTiles.data(),
+                                 m_WallPushMasks.data(),
+                                 static_cast<int>(m_WallPushEntities.size()) );
+
+    for( int pushIndex = 0; pushIndex < m_WallPushEntities.size(); ++pushIndex )
+    {
+        Entity* entity = m_WallPushEntities[ pushIndex ];
+        if( m_WallPushMasks[ pushIndex ] != 0 )
+        {
+            entity->SetPosition( static_cast<Vec3>(m_WallPushCenters[ pushIndex ]) );
         }
+        HandleEntityVsNeighborMudOverlaps( entity, m_WallPushTiles[ pushIndex ] );
+    }
+}
+
+//-----------------------------------------------------------------------------
+void Map::HandleEntityVsNeighborTileOverlaps( Entity* entity, const IntVec2& entityTilePosition )
+{
+    for( int neighborIndex = 0; neighborIndex < NUM_TILE_NEIGHBORS; ++neighborIndex )
+    {
+        HandleEntityVsTileOverlap( entity, GetTileFromPosition( entityTilePosition + TILE_NEIGHBOR_OFFSETS[ neighborIndex ] ) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// The center tile was already handled, only neighbors flagged as mud are tested
+void Map::HandleEntityVsNeighborMudOverlaps( Entity* entity, const IntVec2& entityTilePosition )
+{
+    uint8_t mudMask = m_MudNeighborMasks.GetMask( entityTilePosition );
+    for( int neighborIndex = 0; mudMask != 0; ++neighborIndex, mudMask >>= 1 )
+    {
+        if( (mudMask & 1) == 0 ) { continue; }
+
+        HandleEntityVsTileOverlapOnly( entity, GetTileFromPosition( entityTilePosition + TILE_NEIGHBOR_OFFSETS[ neighborIndex ] ) );
     }
 }
 
@@ -839,11 +2395,11 @@ void Map::HandleEntityVsTileOverlap( Entity* entity, const Tile* tile )
 {
     if( tile == nullptr ) { return; }
 
-    if( tile->IsSolid() )
+    if( IsTileSolid( *tile ) )
     {
         HandleEntityVsTileCollision( entity, tile );
     }
-    else if( !tile->IsSolid() )
+    else
     {
         HandleEntityVsTileOverlapOnly( entity, tile );
     }
@@ -879,7 +2435,7 @@ void Map::HandleEntityVsTileCollision( Entity* entity, const Tile* tile )
         }
         else if( (entity->GetEntityType() == ENTITY_BULLET_ALLIED ||
                 entity->GetEntityType() == ENTITY_BULLET_ENEMY) &&
-            tile->DoesBlockProjectiles() )
+            DoesTileBlockProjectiles( *tile ) )
         {
             entity->Die();
         }
@@ -899,19 +2455,9 @@ Vec2 Map::FindPointNotInWall( const Vec2& bounds )
         boundingBox *= bounds;
         boundingBox.TranslateCenter( pointNotInWall );
 
-        bool foundWallOverlap = false;
-        for( int tileIndex = 0; tileIndex < m_Tiles.size(); ++tileIndex )
-        {
-            Tile& currentTile = m_Tiles.at( tileIndex );
-            if( currentTile.IsSolid() )
-            {
-                if( DoAABB2sOverlap( boundingBox, currentTile.GetTileBoundingBox() ) )
-                {
-                    foundWallOverlap = true;
-                    break;
-                }
-            }
-        }
+        IntVec2 minTile = GetTilePositionFromWorldCoords( boundingBox.mins );
+        IntVec2 maxTile = GetTilePositionFromWorldCoords( boundingBox.maxes );
+        bool foundWallOverlap = m_SolidTiles.IsAnySetInBox( minTile, maxTile );
 
         isInWall = foundWallOverlap;
     }
@@ -926,40 +2472,111 @@ void Map::DeleteGarbageEntities()
     {
         EntityList& currentEntityList = m_EntityListsByType[ entityListIndex ];
 
-        for( int entityIndex = 0; entityIndex < currentEntityList.data.size(); ++entityIndex )
+        // Removal moves the last entity into this slot, so it is checked next
+        int entityIndex = 0;
+        while( entityIndex < currentEntityList.data.size() )
         {
-            Entity*& currentEntity = currentEntityList.data.at( entityIndex );
-            if( currentEntity != nullptr && currentEntity->IsGarbage() )
+            Entity* currentEntity = currentEntityList.data[ entityIndex ];
+            if( !currentEntity->IsGarbage() )
             {
-                currentEntity->Destroy();
-                currentEntityList.RapidRemoval( entityIndex );
+                ++entityIndex;
+                continue;
             }
+
+            currentEntity->Destroy();
+            currentEntity->ReleaseKinematics();
+            m_EntityHandles.Remove( currentEntity->GetHandle() );
+            currentEntityList.RemoveAt( entityIndex );
+            RecycleOrDeleteEntity( currentEntity );
         }
     }
 }
 
+// Entities aren't visited one by one, pooled entities are destroyed with
+// their pools and the rest are let go with the arena. Only spawns that
+// spilled onto the heap need deleting.
 void Map::DestroyEntities()
+{
+    m_ContactCache.Clear();
+    // Spawns still queued would be applied to a map without their source
+    m_CommandBuffer.Clear();
+
+    if( m_NumHeapEntities > 0 )
+    {
+        DeleteHeapEntities();
+    }
+
+    // The player isn't owned by the map, it is only taken off the list
+    for( int entityListIndex = 0; entityListIndex < NUM_ENTITY_TYPES; ++entityListIndex )
+    {
+        m_EntityListsByType[ entityListIndex ].data.clear();
+    }
+    m_EntityHandles.Clear();
+    m_EntityKinematics.Clear();
+
+    // Everything that still refers to entities by list slot or pointer
+    m_EntityGrid.Clear();
+    m_SweepAndPrune.Clear();
+    m_NearbyEntities.clear();
+    m_BroadphasePairs.clear();
+    m_NextBroadphasePair = 0;
+    m_PushPairs.clear();
+    m_SolverEntities.clear();
+    m_SolverContacts.clear();
+    m_FogOfWarViewerTiles.clear();
+    m_IsFogOfWarDirty = true;
+    ClearLineOfSightCache();
+}
+
+void Map::DeleteHeapEntities()
 {
     for( int entityListIndex = 0; entityListIndex < NUM_ENTITY_TYPES; ++entityListIndex )
     {
         if( entityListIndex == ENTITY_PLAYER ) { continue; }
-        EntityList& currentEntityList = m_EntityListsByType[ entityListIndex ];
+        const EntityList& currentEntityList = m_EntityListsByType[ entityListIndex ];
 
         for( int entityIndex = 0; entityIndex < currentEntityList.data.size(); ++entityIndex )
         {
-            Entity*& currentEntity = currentEntityList.data.at( entityIndex );
-            DestroyEntity( currentEntity );
+            Entity* currentEntity = currentEntityList.data[ entityIndex ];
+            if( IsHeapEntity( currentEntity ) )
+            {
+                currentEntity->Destroy();
+                delete currentEntity;
+            }
         }
-
-        currentEntityList.data.clear();
     }
+    m_NumHeapEntities = 0;
 }
 
-void Map::DestroyEntity( Entity*& entityToDestroy )
+bool Map::IsHeapEntity( const Entity* entity ) const
 {
-    if( entityToDestroy == nullptr ) { return; }
+    return !m_BulletPool.Owns( entity ) &&
+           !m_ExplosionPool.Owns( entity ) &&
+           !m_DebrisPool.Owns( entity ) &&
+           !m_Arena.Owns( entity );
+}
 
-    entityToDestroy->Destroy();
-    delete entityToDestroy;
-    entityToDestroy = nullptr;
+void Map::RecycleOrDeleteEntity( Entity* entity )
+{
+    if( m_BulletPool.Owns( entity ) )
+    {
+        m_BulletPool.Release( static_cast<Bullet*>(entity) );
+    }
+    else if( m_ExplosionPool.Owns( entity ) )
+    {
+        m_ExplosionPool.Release( static_cast<Explosion*>(entity) );
+    }
+    else if( m_DebrisPool.Owns( entity ) )
+    {
+        m_DebrisPool.Release( static_cast<Debris*>(entity) );
+    }
+    else if( m_Arena.Owns( entity ) )
+    {
+        // Its memory comes back when the arena is released
+    }
+    else
+    {
+        delete entity;
+        --m_NumHeapEntities;
+    }
 }
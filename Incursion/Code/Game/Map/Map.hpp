@@ -1,13 +1,30 @@
 #pragma once
 
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 #include "Engine/Core/Math/Primatives/IntVec2.hpp"
 
+#include "Game/FrameArena.hpp"
 #include "Game/Entity/Entity.hpp"
+#include "Game/Entity/EntityKinematics.hpp"
+#include "Game/Entity/EntityPool.hpp"
 #include "Game/Map/Tile.hpp"
+#include "Game/Map/CollisionIslands.hpp"
+#include "Game/Map/ContactCache.hpp"
+#include "Game/Map/ContactSolver.hpp"
+#include "Game/Map/EntityGrid.hpp"
+#include "Game/Map/EntityQuery.hpp"
+#include "Game/Map/MapArena.hpp"
+#include "Game/Map/MapCommandBuffer.hpp"
 #include "Game/Map/Generation/MapGeneration.hpp"
+#include "Game/Map/PotentiallyVisibleSet.hpp"
 #include "Game/Map/Raycast.hpp"
+#include "Game/Map/SweepAndPrune.hpp"
+#include "Game/Map/TileBitmap.hpp"
+#include "Game/Map/TileCollision.hpp"
+#include "Game/Map/WallDistanceField.hpp"
 
 struct VertexMaster;
 class Game;
@@ -15,8 +32,20 @@ class World;
 class PlayerCharacter;
 class Bullet;
 class Explosion;
+class Debris;
 class Gameboy;
 
+enum class CollisionBroadphase
+{
+    BRUTE_FORCE,
+    GRID,
+    SWEEP_AND_PRUNE,
+
+    NUM_COLLISION_BROADPHASES
+};
+
+const char* GetCollisionBroadphaseName( CollisionBroadphase broadphase );
+
 class Map
 {
 public:
@@ -29,7 +58,7 @@ public:
     void Create();
     void GenerateMap( MapGeneration& generator);
     void Update( float deltaSeconds );
-    void Render() const;
+    void Render( const AABB2& viewBounds ) const;
     void DebugRender() const;
     void Destroy();
 
@@ -39,6 +68,8 @@ public:
     const IntVec2 GetMapSize() const;
     bool IsPointInSolid( const Vec2& point ) const;
     bool IsPointBlockRaycast( const Vec2& point ) const;
+    float GetWallDistance( const Vec2& point ) const;
+    Vec2 GetWallNormal( const Vec2& point ) const;
 
     //-------------------------------------------------------------------------
     // Tile queries
@@ -50,6 +81,35 @@ public:
     int GetTileIndexFromPosition( const IntVec2& position ) const;
     bool IsTileSolid( const Tile& tile ) const;
     bool DoseTileBlockRaycast( const Tile& tile ) const;
+    bool DoesTileBlockProjectiles( const Tile& tile ) const;
+
+    //-------------------------------------------------------------------------
+    // Entity queries, backed by the entity grid. Only entities that collide
+    // with other entities are found. Matches are written to out_entities up
+    // to maxEntities, and the number written is returned.
+    int QueryEntitiesInDisc( const Vec2& center,
+                             float radius,
+                             const EntityQueryFilter& filter,
+                             Entity** out_entities,
+                             int maxEntities ) const;
+    int QueryEntitiesInAABB( const AABB2& bounds,
+                             const EntityQueryFilter& filter,
+                             Entity** out_entities,
+                             int maxEntities ) const;
+    // Entities whose center is inside the cone and whose disc is in range
+    int QueryEntitiesInCone( const Vec2& origin,
+                             float facingDegrees,
+                             float apertureDegrees,
+                             float range,
+                             const EntityQueryFilter& filter,
+                             Entity** out_entities,
+                             int maxEntities ) const;
+    // Closest entity center within maxDistance, nullptr if there is none
+    Entity* FindNearestEntity( const Vec2& position, float maxDistance, const EntityQueryFilter& filter ) const;
+    // Closest entity the viewer has line of sight to
+    Entity* FindNearestVisibleEntity( const Entity& viewer, float maxDistance, const EntityQueryFilter& filter ) const;
+    // nullptr once the entity has been removed from the map
+    Entity* GetEntity( const EntityHandle& handle ) const   { return m_EntityHandles.Get( handle ); }
 
     //-------------------------------------------------------------------------
     void SetTypeOfTile( const IntVec2& positions, TileType tileType );
@@ -59,13 +119,17 @@ public:
     // Spawning Entities
     Entity* SpawnNewEntityAtStart( EntityType type );
     Entity* SpawnNewEntity( EntityType type, const Vec2& spawnPosition );
-    Explosion* SpawnNewExplosion( const Vec3& position,  
-                                  float duration, 
-                                  const Vec3& scale );
+    // Deferred until the map is done iterating its entities, safe to call
+    // from entity updates and collision handling
+    void RequestSpawnBullet( EntityType type, const Vec3& position, const Vec2& direction );
+    void RequestSpawnExplosion( const Vec3& position, float duration, const Vec3& scale );
     void SpawnNewEntitiesOfTypeInOpenSpace( int number, EntityType type );
+    void SpawnCollisionStressEntities( int numTanks, int numBullets );
     void RequestRespawn( PlayerCharacter* entityToRespawn );
     void AddEntityToMapAtStart( Entity* entity );
     void AddEntityToMap( Entity* entity, const Vec2& spawnPosition );
+    // nullptr once the pool is used up, the caller reuses what it gets
+    Debris* AcquirePooledDebris()       { return m_DebrisPool.Acquire(); }
 
     //-------------------------------------------------------------------------
     // Ray cast Functions
@@ -74,6 +138,37 @@ public:
     RayCastHit RayCastVisual( const Vec2& start, float angleDegrees, float maxDist ) const;
     RayCastHit RayCastVisual( const Vec2& start, const Vec2& direciton, float maxDist ) const;
     bool HasLineOfSight( const Entity& entity1, const Entity& entity2, float maxDist ) const;
+    int GetLineOfSightCacheHits() const     { return m_LineOfSightCacheHits; }
+    int GetLineOfSightCacheMisses() const   { return m_LineOfSightCacheMisses; }
+    int GetNumTilesDrawn() const            { return m_NumTilesDrawn; }
+    int GetNumEntitiesCulled() const        { return m_NumEntitiesCulled; }
+    double GetCollisionSeconds() const      { return m_CollisionSeconds; }
+    CollisionBroadphase GetCollisionBroadphase() const  { return m_CollisionBroadphase; }
+    void SetCollisionBroadphase( CollisionBroadphase broadphase );
+    EntityKinematics& GetEntityKinematics()     { return m_EntityKinematics; }
+    const ContactCache& GetContactCache() const { return m_ContactCache; }
+    ContactSolverMode GetContactSolverMode() const      { return m_ContactSolverMode; }
+    void SetContactSolverMode( ContactSolverMode mode ) { m_ContactSolverMode = mode; }
+    const ContactSolver& GetContactSolver() const       { return m_ContactSolver; }
+    const MapArena& GetArena() const                    { return m_Arena; }
+
+    // Batched ray casts, out_hits must hold numRays entries
+    void RayCastSolidBatch( const Vec2* starts,
+                            const Vec2* directions,
+                            const float* maxDists,
+                            int numRays,
+                            RayCastHit* out_hits ) const;
+    void RayCastVisualBatch( const Vec2* starts,
+                             const Vec2* directions,
+                             const float* maxDists,
+                             int numRays,
+                             RayCastHit* out_hits ) const;
+
+    //-------------------------------------------------------------------------
+    // Debug
+    void BenchmarkRayCasts( int numRays ) const;
+    void BenchmarkBroadphases( int numFrames ) const;
+    void BenchmarkTileCollisions( int numDiscs ) const;
 
 private:
     Game* m_GameInstance = nullptr;
@@ -82,45 +177,203 @@ private:
     IntVec2 m_Size = IntVec2::ZERO;
     int m_NumTiles = 0;
 
+    // Backs the tiles and the tanks, turrets and bolders, which are let go
+    // with it when the map is destroyed. Declared ahead of the containers
+    // that allocate from it.
+    MapArena m_Arena;
+    // Spawns that spilled past a pool onto the heap, only these are deleted
+    // one at a time on teardown
+    int m_NumHeapEntities = 0;
+
     EntityList m_EntityListsByType[ NUM_ENTITY_TYPES ];
-    std::vector<Tile> m_Tiles;
+    EntityHandleTable m_EntityHandles;
+    MapCommandBuffer m_CommandBuffer;
+    MapArenaVector<Tile> m_Tiles;
+
+    // Packed tile flags, kept in sync with m_Tiles by SetTypeOfTile
+    TileBitmap m_SolidTiles;
+    TileBitmap m_RaycastBlockingTiles;
+    TileBitmap m_ProjectileBlockingTiles;
+    TileBitmap m_MudTiles;
+    TileNeighborMasks m_SolidNeighborMasks;
+    TileNeighborMasks m_MudNeighborMasks;
+    WallDistanceField m_WallDistanceField;
+
+    // Baked after generation, rebaked around any tile whose sight blocking changes
+    PotentiallyVisibleSet m_PotentiallyVisibleSet;
+
+    // Fog of war is only recomputed when a viewer changes tile or a tile in
+    // view changes type, otherwise the current seen flags are reused
+    std::vector<IntVec2> m_FogOfWarViewerTiles;
+    IntVec2 m_FogOfWarViewExtents = IntVec2::ZERO;
+    bool m_IsFogOfWarDirty = true;
+    bool m_FogOfWarUsedPerTileRaycast = false;
+    std::vector<IntVec2> m_SlatedVisibleTiles;
+
+    // Line of sight results for this frame keyed by the pair of end points
+    // snapped to 1/MAP_LINE_OF_SIGHT_CACHE_STEPS_PER_TILE of a tile, cleared
+    // at the start of Update and whenever a tile changes type. Queries whose
+    // end points snap to the same spots share the first ray's answer, so a
+    // ray that grazes a wall corner can differ from the exact one by that
+    // much. The pair is unordered, A to B and B to A share an entry.
+    mutable std::unordered_map<uint64_t, bool> m_LineOfSightCache;
+    mutable int m_LineOfSightCacheHits = 0;
+    mutable int m_LineOfSightCacheMisses = 0;
+
+    // Tile vertices are cached per chunk and only rebuilt when a tile setter
+    // marks the chunk dirty
+    struct TileRenderChunk
+    {
+        IntVec2 minTile = IntVec2::ZERO;
+        IntVec2 maxTile = IntVec2::ZERO;
+        bool isDirty = false;
+        std::vector<VertexMaster> vertices;
+    };
+    mutable std::vector<TileRenderChunk> m_TileRenderChunks;
+    mutable bool m_AreTileRenderChunksFogless = false;
+    mutable std::vector<VertexMaster> m_VisibleTileVertices;
+    mutable int m_NumTilesDrawn = 0;
+    mutable int m_NumEntitiesCulled = 0;
+
+    // Broadphase for entity vs entity collisions. The grid is rebuilt every
+    // frame, sweep and prune keeps its sort order from the last frame.
+    CollisionBroadphase m_CollisionBroadphase = CollisionBroadphase::GRID;
+    EntityGrid m_EntityGrid;
+    std::vector<EntityGridEntry> m_NearbyEntities;
+    SweepAndPrune m_SweepAndPrune;
+    std::vector<EntityGridPair> m_BroadphasePairs;
+    int m_NextBroadphasePair = 0;
+    double m_CollisionSeconds = 0.0;
+
+    // Kinematic state of every entity on the map, integrated in one pass
+    // after all entities update
+    EntityKinematics m_EntityKinematics;
+
+    // Short lived entities are constructed once when the map is created and
+    // recycled when they become garbage, spawns past a pool's capacity fall
+    // back to the heap
+    EntityPool<Bullet> m_BulletPool;
+    EntityPool<Explosion> m_ExplosionPool;
+    EntityPool<Debris> m_DebrisPool;
+
+    // Entity contacts carried between frames, with this frame's events
+    ContactCache m_ContactCache;
+
+    // Push pairs split into islands that resolve on separate threads, each
+    // island's contacts are recorded after all of them finish
+    CollisionIslands m_CollisionIslands;
+    std::vector<EntityGridPair> m_PushPairs;
+    std::vector<std::vector<EntityContact>> m_IslandContacts;
+
+    // Push pairs solved together over several iterations, bodies are looked
+    // up by list slot. Opt in with the debug 'C' key, the solver moves every
+    // push pair before tile push out and bullets, which changes gameplay
+    ContactSolverMode m_ContactSolverMode = ContactSolverMode::PAIRWISE;
+    ContactSolver m_ContactSolver;
+    std::vector<int> m_SolverListSlotStarts;
+    std::vector<int> m_SolverBodyOfSlot;
+    std::vector<Entity*> m_SolverEntities;
+    std::vector<EntityContact> m_SolverContacts;
+
+    // Entities pushed by walls are batched per list through the neighbor
+    // tile kernel
+    std::vector<Entity*> m_WallPushEntities;
+    std::vector<Vec2> m_WallPushCenters;
+    std::vector<float> m_WallPushRadii;
+    std::vector<IntVec2> m_WallPushTiles;
+    std::vector<uint8_t> m_WallPushMasks;
+
+    // Swept entities stopped at a wall this frame, they die once entity
+    // collisions have had the chance to hit something earlier on the path
+    std::vector<Entity*> m_SweptWallHits;
 
     IntVec2 m_StartLocation = IntVec2::ZERO;
     IntVec2 m_ExitLocation = IntVec2::ZERO;
 
+    typedef bool (Map::*TileBlockTest)( const IntVec2& tilePos ) const;
+    RayCastHit RayCastTiles( const Vec2& start, 
+                             const Vec2& direction, 
+                             float maxDist, 
+                             TileBlockTest doesTileBlock ) const;
+    void UpdateTileBitmaps( const Tile& tile );
+    void ClearLineOfSightCache();
+    uint32_t GetLineOfSightCachePosition( const Vec2& position ) const;
+    bool IsTilePositionSolid( const IntVec2& tilePos ) const;
+    bool DoesTilePositionBlockRaycast( const IntVec2& tilePos ) const;
+
     void UpdateEntities( float deltaSeconds );
     void UpdateFogOfWar( EntityType revealForEntityType, 
                          int fieldOfView, 
                          int viewHeight,
                          float viewAspect );
     void UpdateFogOfWarOnTilesFrom( const Entity* const& entity, 
-                                    std::vector<Tile*>& tiles );
-    void RenderTiles() const;
+                                    FrameVector<Tile*>& tiles );
+    void ShadowcastFogOfWarFrom( const IntVec2& tilePosOfEntity, int fieldOfView );
+    bool IsFogOfWarStale( const EntityList& fogOfWarList );
+    void UpdateFogOfWarOnSlatedTiles( const EntityList& fogOfWarList );
+    void MarkFogOfWarDirtyAt( const IntVec2& tilePos );
+    void SetTileIsSeen( Tile& tile, bool wasSeen );
+    void SetTileCurrentSeen( Tile& tile, bool isCurrentSeen );
+    void RenderTiles( const AABB2& cullBounds ) const;
+    void CreateTileRenderChunks();
+    void MarkTileRenderChunkDirtyAt( const IntVec2& tilePos );
+    void UpdateTileRenderChunk( TileRenderChunk& chunk ) const;
+    void RebuildTileRenderChunk( TileRenderChunk& chunk ) const;
+    void AppendTileRenderToVector( std::vector<VertexMaster>& vector, const Tile& tile ) const;
     void AppendTileToVectorPCU( std::vector<VertexMaster>& vector, 
                                 const Tile& currentTile,
                                 bool shadeUnseenTiles = true) const;
     void AppendTileDefToVectorPCU( std::vector<VertexMaster>& vector,
                                    const AABB2& bounds,
                                    const TileDefinition& tileDef ) const;
-    void RenderEntities() const;
+    void RenderEntities( const AABB2& cullBounds ) const;
     void DebugRenderEntities() const;
 
     //-------------------------------------------------------------------------
     // Entity Spawner
     Entity* SpawnEntityOfType( EntityType type, const Vec2& spawnPosition );
     void AddEntityToMap( EntityType type, Entity* entity );
+    Explosion* SpawnNewExplosion( const Vec3& position,  
+                                  float duration, 
+                                  const Vec3& scale );
+    void ApplyCommands();
+    void PrewarmEntityPools();
+    Bullet* AcquireBullet( const Vec3& spawnPosition, EntityType type, Faction faction );
 
     void HandleMapCollisions();
+    void SweepEntitiesAgainstTiles();
+    void KillSweptWallHits();
     void HandleListVsListOverlaps( EntityListIndex l1, EntityListIndex l2 );
+    void HandleListVsNearbyOverlaps( EntityListIndex l1 );
+    void HandleListVsBroadphasePairs( EntityListIndex l1 );
+    void GatherBroadphasePairs();
+    void HandleGatheredEntityCollisions();
+    void HandleEntityCollisionsInIslands();
+    void SolvePushPairs();
+    int GetSolverBody( const EntityGridEntry& entry );
+    Entity* GetGridEntryEntity( const EntityGridEntry& entry ) const;
+    void ResolveCollisionIsland( int islandIndex, std::vector<EntityContact>& out_contacts );
+    typedef void (Map::*EntityOverlapHandler)( Entity*& entity1, Entity*& entity2 );
     void HandleEntityVsEntityOverlaps( Entity*& entity1, Entity*& entity2 );
+    void HandleNoOverlap( Entity*& entity1, Entity*& entity2 );
     void HandleOverlapOnly( Entity*& entity1, Entity*& entity2 );
+    EntityContact MakeEntityContact( Entity* entity1, Entity* entity2 ) const;
+    ContactEventType RecordEntityContact( const EntityContact& contact );
+    void WarmStartCoincidentDiscs( const Entity* entity1, const Entity* entity2, const Disc& disc1, Disc& out_disc2 ) const;
+    // Only move the entities passed in and read the contact cache, so islands
+    // can resolve on worker threads
+    bool ResolvePushedVsPushed( Entity* entity1, Entity* entity2, EntityContact& out_contact );
+    bool ResolvePushedVsFixed( Entity* pushed, Entity* fixed, EntityContact& out_contact );
     void HandlePushedVsPushed( Entity*& entity1, Entity*& entity2 );
     void DeterminePushedVsFixedEntity( Entity*& entity1, Entity*& entity2 );
-    void HandlePushedVsFixed( Entity*& pushed, const Entity* fixed );
+    void HandlePushedVsFixed( Entity*& pushed, Entity* fixed );
     void HandleEntityVsBulletCollision( Entity*& entity, Bullet*& bullet );
+    void HandleBulletContactEvents();
 
     void HandleListVsTileOverlaps( EntityListIndex l1 );
     void HandleEntityVsTileOverlap( Entity* entity, const Tile* tile );
+    void HandleEntityVsNeighborTileOverlaps( Entity* entity, const IntVec2& entityTilePosition );
+    void HandleEntityVsNeighborMudOverlaps( Entity* entity, const IntVec2& entityTilePosition );
     void HandleEntityVsTileOverlapOnly( Entity* entity, const Tile* tile );
     void HandleEntityVsTileCollision( Entity* entity, const Tile* tile );
 
@@ -130,5 +383,9 @@ private:
 
     void DeleteGarbageEntities();
     void DestroyEntities();
-    void DestroyEntity( Entity*& entityToDestroy );
+    void DeleteHeapEntities();
+    bool IsHeapEntity( const Entity* entity ) const;
+    // Pooled entities go back to their pool, arena entities are left for the
+    // arena, everything else is deleted
+    void RecycleOrDeleteEntity( Entity* entity );
 };
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "MapArena.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+//-----------------------------------------------------------------------------
+MapArena::MapArena( size_t chunkBytes )
+    : m_ChunkBytes( chunkBytes )
+{
+}
+
+MapArena::~MapArena()
+{
+    Release();
+}
+
+//-----------------------------------------------------------------------------
+void MapArena::Release()
+{
+    for( int chunkIndex = 0; chunkIndex < m_Chunks.size(); ++chunkIndex )
+    {
+        std::free( m_Chunks[ chunkIndex ].buffer );
+    }
+    m_Chunks.clear();
+
+    m_Offset = 0;
+    m_BytesUsed = 0;
+    m_BytesReserved = 0;
+}
+
+void* MapArena::Allocate( size_t numBytes, size_t alignment )
+{
+    m_BytesUsed += numBytes;
+
+    if( !m_Chunks.empty() )
+    {
+        Chunk& chunk = m_Chunks.back();
+        uintptr_t bufferAddress = reinterpret_cast<uintptr_t>(chunk.buffer);
+        uintptr_t alignedAddress = (bufferAddress + m_Offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        size_t alignedOffset = static_cast<size_t>(alignedAddress - bufferAddress);
+        if( alignedOffset + numBytes <= chunk.capacity )
+        {
+            m_Offset = alignedOffset + numBytes;
+            return chunk.buffer + alignedOffset;
+        }
+    }
+
+    // Whatever is left in the old chunk is given up, big requests get a
+    // chunk of their own
+    AddChunk( numBytes + alignment );
+    Chunk& chunk = m_Chunks.back();
+    uintptr_t bufferAddress = reinterpret_cast<uintptr_t>(chunk.buffer);
+    uintptr_t alignedAddress = (bufferAddress + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    size_t alignedOffset = static_cast<size_t>(alignedAddress - bufferAddress);
+    m_Offset = alignedOffset + numBytes;
+    return chunk.buffer + alignedOffset;
+}
+
+bool MapArena::Owns( const void* address ) const
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(address);
+    for( int chunkIndex = 0; chunkIndex < m_Chunks.size(); ++chunkIndex )
+    {
+        const Chunk& chunk = m_Chunks[ chunkIndex ];
+        if( bytes >= chunk.buffer && bytes < chunk.buffer + chunk.capacity ) { return true; }
+    }
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+void MapArena::AddChunk( size_t minBytes )
+{
+    Chunk chunk;
+    chunk.capacity = minBytes > m_ChunkBytes ? minBytes : m_ChunkBytes;
+    chunk.buffer = static_cast<unsigned char*>(std::malloc( chunk.capacity ));
+    m_Chunks.push_back( chunk );
+
+    m_Offset = 0;
+    m_BytesReserved += chunk.capacity;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+template<typename T> class MapArenaAllocator;
+
+//-----------------------------------------------------------------------------
+// Chunked bump allocator for memory that lives as long as a map. Nothing is
+// freed on its own, Release hands every chunk back, so its cost follows the
+// number of chunks rather than the number of objects. Objects made with New
+// never have their destructors run and must not own memory outside the arena.
+class MapArena
+{
+public:
+    explicit MapArena( size_t chunkBytes );
+    ~MapArena();
+    MapArena( const MapArena& ) = delete;
+    MapArena& operator=( const MapArena& ) = delete;
+
+    void Release();
+
+    void* Allocate( size_t numBytes, size_t alignment );
+    bool Owns( const void* address ) const;
+
+    template<typename T, typename... ARGS>
+    T* New( ARGS&&... args );
+    template<typename T>
+    MapArenaAllocator<T> GetAllocator()         { return MapArenaAllocator<T>( this ); }
+
+    size_t GetBytesUsed() const                 { return m_BytesUsed; }
+    size_t GetBytesReserved() const             { return m_BytesReserved; }
+    int GetNumChunks() const                    { return static_cast<int>(m_Chunks.size()); }
+
+private:
+    struct Chunk
+    {
+        unsigned char* buffer = nullptr;
+        size_t capacity = 0;
+    };
+
+    size_t m_ChunkBytes = 0;
+    std::vector<Chunk> m_Chunks;
+    // Allocations bump through the last chunk only
+    size_t m_Offset = 0;
+
+    size_t m_BytesUsed = 0;
+    size_t m_BytesReserved = 0;
+
+    void AddChunk( size_t minBytes );
+};
+
+//-----------------------------------------------------------------------------
+template<typename T, typename... ARGS>
+T* MapArena::New( ARGS&&... args )
+{
+    void* memory = Allocate( sizeof( T ), alignof(T) );
+    return new(memory) T( std::forward<ARGS>( args )... );
+}
+
+//-----------------------------------------------------------------------------
+// STL allocator over a MapArena for containers scoped to the map. Freed
+// memory is only reclaimed when the arena is released, so reserve up front.
+template<typename T>
+class MapArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    explicit MapArenaAllocator( MapArena* arena ) : m_Arena( arena ) {}
+    template<typename OTHER_TYPE>
+    MapArenaAllocator( const MapArenaAllocator<OTHER_TYPE>& other ) : m_Arena( other.GetArena() ) {}
+
+    T* allocate( size_t count )             { return static_cast<T*>(m_Arena->Allocate( count * sizeof( T ), alignof(T) )); }
+    void deallocate( T*, size_t )           {}
+
+    MapArena* GetArena() const              { return m_Arena; }
+
+private:
+    MapArena* m_Arena = nullptr;
+};
+
+template<typename T1, typename T2>
+bool operator==( const MapArenaAllocator<T1>& allocator1, const MapArenaAllocator<T2>& allocator2 )
+{
+    return allocator1.GetArena() == allocator2.GetArena();
+}
+
+template<typename T1, typename T2>
+bool operator!=( const MapArenaAllocator<T1>& allocator1, const MapArenaAllocator<T2>& allocator2 )
+{
+    return !(allocator1 == allocator2);
+}
+
+template<typename T>
+using MapArenaVector = std::vector<T, MapArenaAllocator<T>>;
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "MapCommandBuffer.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include "Game/ThreadPool.hpp"
+
+//-----------------------------------------------------------------------------
+void MapCommandBuffer::Resize( int numWorkers )
+{
+    m_ThreadQueues.resize( numWorkers + 1 );
+}
+
+void MapCommandBuffer::RecordSpawnBullet( EntityType type, const Vec3& position, const Vec2& direction )
+{
+    MapCommand command;
+    command.type = MapCommandType::SPAWN_BULLET;
+    command.entityType = type;
+    command.position = position;
+    command.direction = direction;
+    GetCurrentThreadQueue().push_back( command );
+}
+
+void MapCommandBuffer::RecordSpawnExplosion( const Vec3& position, float duration, const Vec3& scale )
+{
+    MapCommand command;
+    command.type = MapCommandType::SPAWN_EXPLOSION;
+    command.entityType = ENTITY_EXPLOSION;
+    command.position = position;
+    command.duration = duration;
+    command.scale = scale;
+    GetCurrentThreadQueue().push_back( command );
+}
+
+bool MapCommandBuffer::IsEmpty() const
+{
+    for( int queueIndex = 0; queueIndex < m_ThreadQueues.size(); ++queueIndex )
+    {
+        if( !m_ThreadQueues[ queueIndex ].empty() ) { return false; }
+    }
+    return true;
+}
+
+void MapCommandBuffer::Clear()
+{
+    for( int queueIndex = 0; queueIndex < m_ThreadQueues.size(); ++queueIndex )
+    {
+        m_ThreadQueues[ queueIndex ].clear();
+    }
+}
+
+//-----------------------------------------------------------------------------
+std::vector<MapCommand>& MapCommandBuffer::GetCurrentThreadQueue()
+{
+    int threadIndex = ThreadPool::GetCurrentThreadIndex();
+    if( threadIndex >= m_ThreadQueues.size() )
+    {
+        ERROR_AND_DIE( Stringf( "Map command recorded from thread %i with only %i queues", threadIndex, static_cast<int>(m_ThreadQueues.size()) ) );
+    }
+    return m_ThreadQueues[ threadIndex ];
+}
\ No newline at end of file
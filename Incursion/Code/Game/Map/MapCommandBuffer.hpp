@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+#include "Engine/Core/Math/Primatives/Vec3.hpp"
+
+#include "Game/Entity/Entity.hpp"
+
+enum class MapCommandType
+{
+    SPAWN_BULLET,
+    SPAWN_EXPLOSION,
+};
+
+struct MapCommand
+{
+    MapCommandType type = MapCommandType::SPAWN_BULLET;
+    EntityType entityType = ENTITY_INVALID;
+    Vec3 position = Vec3::ZERO;
+    Vec2 direction = Vec2::ZERO;        // Bullets
+    float duration = 0.f;               // Explosions
+    Vec3 scale = Vec3::ONE;             // Explosions
+};
+
+//-----------------------------------------------------------------------------
+// Spawns recorded while the map is iterating its entity lists, applied by the
+// map once nothing is iterating them. Every thread in the game's ThreadPool
+// records into its own queue, so recording takes no lock. Only the thread
+// driving the pool may record from outside it.
+class MapCommandBuffer
+{
+public:
+    // One queue for the driving thread plus one per worker
+    void Resize( int numWorkers );
+
+    void RecordSpawnBullet( EntityType type, const Vec3& position, const Vec2& direction );
+    void RecordSpawnExplosion( const Vec3& position, float duration, const Vec3& scale );
+
+    bool IsEmpty() const;
+    // Drops every recorded command without applying it
+    void Clear();
+
+    // Calls applyCommand( command ) for every command, the driving thread's
+    // first and each queue in the order it was recorded, then empties the
+    // queues. Commands recorded while applying are applied in the same flush.
+    template<typename APPLY_COMMAND>
+    void Flush( APPLY_COMMAND applyCommand );
+
+private:
+    std::vector<std::vector<MapCommand>> m_ThreadQueues;
+
+    std::vector<MapCommand>& GetCurrentThreadQueue();
+};
+
+//-----------------------------------------------------------------------------
+template<typename APPLY_COMMAND>
+void MapCommandBuffer::Flush( APPLY_COMMAND applyCommand )
+{
+    for( int queueIndex = 0; queueIndex < m_ThreadQueues.size(); ++queueIndex )
+    {
+        std::vector<MapCommand>& queue = m_ThreadQueues[ queueIndex ];
+        for( int commandIndex = 0; commandIndex < queue.size(); ++commandIndex )
+        {
+            // Copied out since applying can record into this queue
+            MapCommand command = queue[ commandIndex ];
+            applyCommand( command );
+        }
+        queue.clear();
+    }
+}
\ No newline at end of file
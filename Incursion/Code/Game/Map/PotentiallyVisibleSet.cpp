@@ -0,0 +1,254 @@
+#include "PotentiallyVisibleSet.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "Game/GameCommon.hpp"
+#include "Game/Map/Shadowcast.hpp"
+#include "Game/Map/TileBitmap.hpp"
+
+constexpr int BITS_PER_WORD = 64;
+constexpr int WORD_SHIFT = 6;
+constexpr int BIT_MASK = BITS_PER_WORD - 1;
+
+//-----------------------------------------------------------------------------
+void PotentiallyVisibleSet::Bake( const TileBitmap& sightBlockers, int radius )
+{
+    Clear();
+    if( radius <= 0 ) { return; }
+
+    m_MapSize = sightBlockers.GetSize();
+    m_Radius = radius;
+    m_WindowWidth = 2 * radius + 1;
+    m_WordsPerTile = (m_WindowWidth * m_WindowWidth + BIT_MASK) >> WORD_SHIFT;
+
+    int numSlots = 0;
+    m_SlotByTileIndex.resize( m_MapSize.x * m_MapSize.y, -1 );
+    for( int tileY = 0; tileY < m_MapSize.y; ++tileY )
+    {
+        for( int tileX = 0; tileX < m_MapSize.x; ++tileX )
+        {
+            if( !sightBlockers.IsSet( IntVec2( tileX, tileY ) ) )
+            {
+                m_SlotByTileIndex[ tileY * m_MapSize.x + tileX ] = numSlots++;
+            }
+        }
+    }
+    m_VisibleBits.resize( numSlots * m_WordsPerTile, 0 );
+    m_BoundaryBits.resize( numSlots * m_WordsPerTile, 0 );
+
+    // Shadowcast from every open tile first, the boundary pass compares neighbors
+    std::vector<IntVec2> visibleTiles;
+    for( int tileY = 0; tileY < m_MapSize.y; ++tileY )
+    {
+        for( int tileX = 0; tileX < m_MapSize.x; ++tileX )
+        {
+            BakeVisibleBits( sightBlockers, IntVec2( tileX, tileY ), visibleTiles );
+        }
+    }
+    for( int tileY = 0; tileY < m_MapSize.y; ++tileY )
+    {
+        for( int tileX = 0; tileX < m_MapSize.x; ++tileX )
+        {
+            BakeBoundaryBits( IntVec2( tileX, tileY ) );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// A changed tile only shadows tiles within radius of a viewer, and the
+// boundary bits also read the answers from the viewer's neighbors, so every
+// viewer that can change is within radius + 2 taxicab of it
+void PotentiallyVisibleSet::RebakeAroundTile( const TileBitmap& sightBlockers, const IntVec2& changedTile )
+{
+    if( !IsBaked() ) { return; }
+    if( changedTile.x < 0 || changedTile.y < 0 || changedTile.x >= m_MapSize.x || changedTile.y >= m_MapSize.y ) { return; }
+
+    int& changedSlot = m_SlotByTileIndex[ changedTile.y * m_MapSize.x + changedTile.x ];
+    if( sightBlockers.IsSet( changedTile ) )
+    {
+        changedSlot = -1;
+    }
+    else if( changedSlot < 0 )
+    {
+        changedSlot = static_cast<int>(m_VisibleBits.size()) / m_WordsPerTile;
+        m_VisibleBits.resize( m_VisibleBits.size() + m_WordsPerTile, 0 );
+        m_BoundaryBits.resize( m_BoundaryBits.size() + m_WordsPerTile, 0 );
+    }
+
+    int reach = m_Radius + 2;
+    IntVec2 mins = IntVec2( changedTile.x - reach > 0 ? changedTile.x - reach : 0,
+                            changedTile.y - reach > 0 ? changedTile.y - reach : 0 );
+    IntVec2 maxs = IntVec2( changedTile.x + reach < m_MapSize.x - 1 ? changedTile.x + reach : m_MapSize.x - 1,
+                            changedTile.y + reach < m_MapSize.y - 1 ? changedTile.y + reach : m_MapSize.y - 1 );
+
+    std::vector<IntVec2> visibleTiles;
+    for( int tileY = mins.y; tileY <= maxs.y; ++tileY )
+    {
+        for( int tileX = mins.x; tileX <= maxs.x; ++tileX )
+        {
+            IntVec2 fromTile = IntVec2( tileX, tileY );
+            if( IntVec2::GetTaxicabDistance( fromTile, changedTile ) <= reach )
+            {
+                BakeVisibleBits( sightBlockers, fromTile, visibleTiles );
+            }
+        }
+    }
+    for( int tileY = mins.y; tileY <= maxs.y; ++tileY )
+    {
+        for( int tileX = mins.x; tileX <= maxs.x; ++tileX )
+        {
+            IntVec2 fromTile = IntVec2( tileX, tileY );
+            if( IntVec2::GetTaxicabDistance( fromTile, changedTile ) <= reach )
+            {
+                BakeBoundaryBits( fromTile );
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void PotentiallyVisibleSet::BakeVisibleBits( const TileBitmap& sightBlockers, const IntVec2& fromTile, std::vector<IntVec2>& visibleTiles )
+{
+    int slot = GetSlot( fromTile );
+    if( slot < 0 ) { return; }
+
+    uint64_t* visibleWords = &m_VisibleBits[ slot * m_WordsPerTile ];
+    std::fill( visibleWords, visibleWords + m_WordsPerTile, 0 );
+
+    visibleTiles.clear();
+    ShadowcastVisibleTiles( sightBlockers, fromTile, m_Radius, visibleTiles );
+    for( int visibleIndex = 0; visibleIndex < visibleTiles.size(); ++visibleIndex )
+    {
+        int bitIndex = GetWindowBitIndex( fromTile, visibleTiles[ visibleIndex ] );
+        if( bitIndex >= 0 )
+        {
+            SetBit( visibleWords, bitIndex );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// A pair is on the boundary when moving either end to a neighboring open
+// tile changes the answer
+void PotentiallyVisibleSet::BakeBoundaryBits( const IntVec2& fromTile )
+{
+    int slot = GetSlot( fromTile );
+    if( slot < 0 ) { return; }
+
+    uint64_t* boundaryWords = &m_BoundaryBits[ slot * m_WordsPerTile ];
+    std::fill( boundaryWords, boundaryWords + m_WordsPerTile, 0 );
+
+    for( int offsetY = -m_Radius; offsetY <= m_Radius; ++offsetY )
+    {
+        int rowWidth = m_Radius - abs( offsetY );
+        for( int offsetX = -rowWidth; offsetX <= rowWidth; ++offsetX )
+        {
+            IntVec2 toTile = IntVec2( fromTile.x + offsetX, fromTile.y + offsetY );
+            if( !HasTile( toTile ) ) { continue; }
+
+            bool isVisible = IsVisibleFromTileCenter( fromTile, toTile );
+            bool isOnBoundary = false;
+            for( int neighborY = -1; neighborY <= 1 && !isOnBoundary; ++neighborY )
+            {
+                for( int neighborX = -1; neighborX <= 1 && !isOnBoundary; ++neighborX )
+                {
+                    IntVec2 toNeighbor = IntVec2( toTile.x + neighborX, toTile.y + neighborY );
+                    if( HasTile( toNeighbor ) && GetWindowBitIndex( fromTile, toNeighbor ) >= 0 &&
+                        IsVisibleFromTileCenter( fromTile, toNeighbor ) != isVisible )
+                    {
+                        isOnBoundary = true;
+                    }
+
+                    IntVec2 fromNeighbor = IntVec2( fromTile.x + neighborX, fromTile.y + neighborY );
+                    if( HasTile( fromNeighbor ) && GetWindowBitIndex( fromNeighbor, toTile ) >= 0 &&
+                        IsVisibleFromTileCenter( fromNeighbor, toTile ) != isVisible )
+                    {
+                        isOnBoundary = true;
+                    }
+                }
+            }
+
+            if( isOnBoundary )
+            {
+                SetBit( boundaryWords, GetWindowBitIndex( fromTile, toTile ) );
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void PotentiallyVisibleSet::Clear()
+{
+    m_MapSize = IntVec2::ZERO;
+    m_Radius = 0;
+    m_WindowWidth = 0;
+    m_WordsPerTile = 0;
+    m_SlotByTileIndex.clear();
+    m_VisibleBits.clear();
+    m_BoundaryBits.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool PotentiallyVisibleSet::HasTile( const IntVec2& fromTile ) const
+{
+    return GetSlot( fromTile ) >= 0;
+}
+
+//-----------------------------------------------------------------------------
+PvsVisibility PotentiallyVisibleSet::GetVisibility( const IntVec2& fromTile, const IntVec2& toTile ) const
+{
+    int slot = GetSlot( fromTile );
+    if( slot < 0 ) { return PVS_UNKNOWN; }
+
+    int bitIndex = GetWindowBitIndex( fromTile, toTile );
+    if( bitIndex < 0 ) { return PVS_UNKNOWN; }
+    if( IsBitSet( &m_BoundaryBits[ slot * m_WordsPerTile ], bitIndex ) ) { return PVS_UNKNOWN; }
+
+    return IsBitSet( &m_VisibleBits[ slot * m_WordsPerTile ], bitIndex ) ? PVS_VISIBLE : PVS_NOT_VISIBLE;
+}
+
+//-----------------------------------------------------------------------------
+bool PotentiallyVisibleSet::IsVisibleFromTileCenter( const IntVec2& fromTile, const IntVec2& toTile ) const
+{
+    int slot = GetSlot( fromTile );
+    if( slot < 0 ) { return false; }
+
+    int bitIndex = GetWindowBitIndex( fromTile, toTile );
+    if( bitIndex < 0 ) { return false; }
+
+    return IsBitSet( &m_VisibleBits[ slot * m_WordsPerTile ], bitIndex );
+}
+
+//-----------------------------------------------------------------------------
+int PotentiallyVisibleSet::GetSlot( const IntVec2& fromTile ) const
+{
+    if( !IsBaked() ) { return -1; }
+    if( fromTile.x < 0 || fromTile.y < 0 || fromTile.x >= m_MapSize.x || fromTile.y >= m_MapSize.y ) { return -1; }
+
+    return m_SlotByTileIndex[ fromTile.y * m_MapSize.x + fromTile.x ];
+}
+
+//-----------------------------------------------------------------------------
+int PotentiallyVisibleSet::GetWindowBitIndex( const IntVec2& fromTile, const IntVec2& toTile ) const
+{
+    int offsetX = toTile.x - fromTile.x;
+    int offsetY = toTile.y - fromTile.y;
+    if( abs( offsetX ) + abs( offsetY ) > m_Radius ) { return -1; }
+    if( toTile.x < 0 || toTile.y < 0 || toTile.x >= m_MapSize.x || toTile.y >= m_MapSize.y ) { return -1; }
+
+    return (offsetY + m_Radius) * m_WindowWidth + (offsetX + m_Radius);
+}
+
+//-----------------------------------------------------------------------------
+bool PotentiallyVisibleSet::IsBitSet( const uint64_t* words, int bitIndex )
+{
+    return (words[ bitIndex >> WORD_SHIFT ] >> (bitIndex & BIT_MASK)) & 1;
+}
+
+//-----------------------------------------------------------------------------
+void PotentiallyVisibleSet::SetBit( uint64_t* words, int bitIndex )
+{
+    words[ bitIndex >> WORD_SHIFT ] |= uint64_t( 1 ) << (bitIndex & BIT_MASK);
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/IntVec2.hpp"
+
+class TileBitmap;
+
+enum PvsVisibility
+{
+    PVS_NOT_VISIBLE,
+    PVS_VISIBLE,
+    PVS_UNKNOWN,
+};
+
+//-----------------------------------------------------------------------------
+// Baked visibility for static maps. Every open tile stores a bitset over the
+// tiles within taxicab radius of it, the same shape the fog of war
+// shadowcast uses, holding the tiles shadowcast from its center and the
+// tiles next to a change in visibility. Answers for those boundary tiles
+// depend on where in the tile the viewer stands, so they come back as
+// PVS_UNKNOWN. The rest are still answers from tile centers, callers that
+// need an exact answer should only trust PVS_NOT_VISIBLE as an early out.
+// The diamond is indexed through its enclosing square.
+class PotentiallyVisibleSet
+{
+public:
+    void Bake( const TileBitmap& sightBlockers, int radius );
+    void RebakeAroundTile( const TileBitmap& sightBlockers, const IntVec2& changedTile );
+    void Clear();
+
+    bool IsBaked() const    { return m_Radius > 0; }
+    int GetRadius() const   { return m_Radius; }
+    bool HasTile( const IntVec2& fromTile ) const;
+
+    PvsVisibility GetVisibility( const IntVec2& fromTile, const IntVec2& toTile ) const;
+    bool IsVisibleFromTileCenter( const IntVec2& fromTile, const IntVec2& toTile ) const;
+
+private:
+    IntVec2 m_MapSize = IntVec2::ZERO;
+    int m_Radius = 0;
+    int m_WindowWidth = 0;
+    int m_WordsPerTile = 0;
+
+    // Only open tiles get a slot, blocking tiles map to -1. A tile closed by a
+    // rebake leaves its slot unused until the next full bake
+    std::vector<int> m_SlotByTileIndex;
+    std::vector<uint64_t> m_VisibleBits;
+    std::vector<uint64_t> m_BoundaryBits;
+
+    void BakeVisibleBits( const TileBitmap& sightBlockers, const IntVec2& fromTile, std::vector<IntVec2>& visibleTiles );
+    void BakeBoundaryBits( const IntVec2& fromTile );
+    int GetSlot( const IntVec2& fromTile ) const;
+    int GetWindowBitIndex( const IntVec2& fromTile, const IntVec2& toTile ) const;
+    static bool IsBitSet( const uint64_t* words, int bitIndex );
+    static void SetBit( uint64_t* words, int bitIndex );
+};
\ No newline at end of file
@@ -1,8 +1,173 @@
 #include "Raycast.hpp"
 
+#include <cmath>
+#include <limits>
+#include <emmintrin.h>
+
+#include "Game/Map/TileBitmap.hpp"
+
 RayCastHit::RayCastHit( bool wasHit, const Vec2& hitPos, float finish )
     : didHit( wasHit )
     , hitPosition( hitPos )
     , percentToFinish( finish )
 {
+}
+RayCastHit::RayCastHit( bool wasHit, const Vec2& hitPos, float finish, const IntVec2& hitTile )
+    : didHit( wasHit )
+    , hitPosition( hitPos )
+    , percentToFinish( finish )
+    , hitTilePosition( hitTile )
+{
+}
+
+//-----------------------------------------------------------------------------
+static bool DoesTileBlockBatchRay( const TileBitmap& blockers, const IntVec2& tilePos )
+{
+    if( !blockers.IsInBounds( tilePos ) ) { return true; }
+    return blockers.IsSet( tilePos );
+}
+
+//-----------------------------------------------------------------------------
+// Lane state is set up per ray, then every lane takes one tile step per
+// iteration. Only the bitmap lookups are scalar since SSE2 has no gather.
+static void RayCastTilesLanes( const TileBitmap& blockers,
+                               const Vec2* starts,
+                               const Vec2* directions,
+                               const float* maxDists,
+                               int numLanes,
+                               RayCastHit* out_hits )
+{
+    constexpr float NEVER_CROSSES = std::numeric_limits<float>::infinity();
+
+    alignas(16) int tileX[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) int tileY[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) int stepX[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) int stepY[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) float deltaDistX[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) float deltaDistY[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) float nextCrossX[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) float nextCrossY[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) float laneMaxDist[ RAYCAST_BATCH_LANES ] = {};
+    alignas(16) int isLaneActive[ RAYCAST_BATCH_LANES ] = {};
+    Vec2 forward[ RAYCAST_BATCH_LANES ];
+
+    for( int lane = 0; lane < numLanes; ++lane )
+    {
+        const Vec2& start = starts[ lane ];
+        IntVec2 tilePos = IntVec2( static_cast<int>(start.x), static_cast<int>(start.y) );
+        tileX[ lane ] = tilePos.x;
+        tileY[ lane ] = tilePos.y;
+
+        if( DoesTileBlockBatchRay( blockers, tilePos ) )
+        {
+            out_hits[ lane ] = RayCastHit( true, start, 0.f, tilePos );
+            continue;
+        }
+
+        float directionLength = directions[ lane ].GetLength();
+        if( directionLength == 0.f || maxDists[ lane ] <= 0.f )
+        {
+            out_hits[ lane ] = RayCastHit( false, start, 1.f, tilePos );
+            continue;
+        }
+
+        forward[ lane ] = directions[ lane ] / directionLength;
+        const Vec2& laneForward = forward[ lane ];
+        stepX[ lane ] = laneForward.x > 0.f ? 1 : -1;
+        stepY[ lane ] = laneForward.y > 0.f ? 1 : -1;
+        deltaDistX[ lane ] = laneForward.x != 0.f ? fabsf( 1.f / laneForward.x ) : NEVER_CROSSES;
+        deltaDistY[ lane ] = laneForward.y != 0.f ? fabsf( 1.f / laneForward.y ) : NEVER_CROSSES;
+
+        float firstEdgeX = stepX[ lane ] > 0 ? static_cast<float>(tilePos.x + 1) - start.x : start.x - static_cast<float>(tilePos.x);
+        float firstEdgeY = stepY[ lane ] > 0 ? static_cast<float>(tilePos.y + 1) - start.y : start.y - static_cast<float>(tilePos.y);
+        nextCrossX[ lane ] = laneForward.x != 0.f ? firstEdgeX * deltaDistX[ lane ] : NEVER_CROSSES;
+        nextCrossY[ lane ] = laneForward.y != 0.f ? firstEdgeY * deltaDistY[ lane ] : NEVER_CROSSES;
+
+        laneMaxDist[ lane ] = maxDists[ lane ];
+        isLaneActive[ lane ] = -1;
+    }
+
+    __m128i tileXLanes = _mm_load_si128( reinterpret_cast<const __m128i*>(tileX) );
+    __m128i tileYLanes = _mm_load_si128( reinterpret_cast<const __m128i*>(tileY) );
+    const __m128i stepXLanes = _mm_load_si128( reinterpret_cast<const __m128i*>(stepX) );
+    const __m128i stepYLanes = _mm_load_si128( reinterpret_cast<const __m128i*>(stepY) );
+    const __m128 deltaDistXLanes = _mm_load_ps( deltaDistX );
+    const __m128 deltaDistYLanes = _mm_load_ps( deltaDistY );
+    __m128 nextCrossXLanes = _mm_load_ps( nextCrossX );
+    __m128 nextCrossYLanes = _mm_load_ps( nextCrossY );
+    const __m128 maxDistLanes = _mm_load_ps( laneMaxDist );
+    __m128i activeLanes = _mm_load_si128( reinterpret_cast<const __m128i*>(isLaneActive) );
+
+    alignas(16) float crossDist[ RAYCAST_BATCH_LANES ];
+    while( _mm_movemask_ps( _mm_castsi128_ps( activeLanes ) ) != 0 )
+    {
+        // Pick the nearer tile edge per lane, lanes that pass their max distance are done
+        __m128 crossesX = _mm_cmplt_ps( nextCrossXLanes, nextCrossYLanes );
+        __m128 crossDistLanes = _mm_or_ps( _mm_and_ps( crossesX, nextCrossXLanes ),
+                                           _mm_andnot_ps( crossesX, nextCrossYLanes ) );
+        __m128i isPastEnd = _mm_castps_si128( _mm_cmpgt_ps( crossDistLanes, maxDistLanes ) );
+        int finishedMask = _mm_movemask_ps( _mm_castsi128_ps( _mm_and_si128( activeLanes, isPastEnd ) ) );
+        activeLanes = _mm_andnot_si128( isPastEnd, activeLanes );
+
+        // Step active lanes into their next tile
+        __m128i stepsX = _mm_and_si128( activeLanes, _mm_castps_si128( crossesX ) );
+        __m128i stepsY = _mm_andnot_si128( _mm_castps_si128( crossesX ), activeLanes );
+        tileXLanes = _mm_add_epi32( tileXLanes, _mm_and_si128( stepsX, stepXLanes ) );
+        tileYLanes = _mm_add_epi32( tileYLanes, _mm_and_si128( stepsY, stepYLanes ) );
+        nextCrossXLanes = _mm_add_ps( nextCrossXLanes, _mm_and_ps( _mm_castsi128_ps( stepsX ), deltaDistXLanes ) );
+        nextCrossYLanes = _mm_add_ps( nextCrossYLanes, _mm_and_ps( _mm_castsi128_ps( stepsY ), deltaDistYLanes ) );
+
+        _mm_store_si128( reinterpret_cast<__m128i*>(tileX), tileXLanes );
+        _mm_store_si128( reinterpret_cast<__m128i*>(tileY), tileYLanes );
+        _mm_store_ps( crossDist, crossDistLanes );
+
+        int activeMask = _mm_movemask_ps( _mm_castsi128_ps( activeLanes ) );
+        for( int lane = 0; lane < numLanes; ++lane )
+        {
+            IntVec2 tilePos = IntVec2( tileX[ lane ], tileY[ lane ] );
+            if( finishedMask & (1 << lane) )
+            {
+                out_hits[ lane ] = RayCastHit( false,
+                                               starts[ lane ] + forward[ lane ] * laneMaxDist[ lane ],
+                                               1.f,
+                                               tilePos );
+                isLaneActive[ lane ] = 0;
+            }
+            else if( (activeMask & (1 << lane)) && DoesTileBlockBatchRay( blockers, tilePos ) )
+            {
+                out_hits[ lane ] = RayCastHit( true,
+                                               starts[ lane ] + forward[ lane ] * crossDist[ lane ],
+                                               crossDist[ lane ] / laneMaxDist[ lane ],
+                                               tilePos );
+                isLaneActive[ lane ] = 0;
+            }
+            else
+            {
+                isLaneActive[ lane ] = (activeMask & (1 << lane)) ? -1 : 0;
+            }
+        }
+        activeLanes = _mm_load_si128( reinterpret_cast<const __m128i*>(isLaneActive) );
+    }
+}
+
+//-----------------------------------------------------------------------------
+void RayCastTilesBatch( const TileBitmap& blockers,
+                        const Vec2* starts,
+                        const Vec2* directions,
+                        const float* maxDists,
+                        int numRays,
+                        RayCastHit* out_hits )
+{
+    for( int firstRay = 0; firstRay < numRays; firstRay += RAYCAST_BATCH_LANES )
+    {
+        int numLanes = numRays - firstRay;
+        if( numLanes > RAYCAST_BATCH_LANES ) { numLanes = RAYCAST_BATCH_LANES; }
+
+        RayCastTilesLanes( blockers,
+                           starts + firstRay,
+                           directions + firstRay,
+                           maxDists + firstRay,
+                           numLanes,
+                           out_hits + firstRay );
+    }
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Engine/Core/Math/Primatives/Vec2.hpp"
+#include "Engine/Core/Math/Primatives/IntVec2.hpp"
+
+class TileBitmap;
 
 struct RayCastHit
 {
@@ -8,9 +11,22 @@ public:
     bool didHit = false;
     Vec2 hitPosition = Vec2::ZERO;
     float percentToFinish = 0.f;
+    IntVec2 hitTilePosition = IntVec2::ZERO;   // Blocking tile if hit, last tile walked otherwise
 
     RayCastHit() {}
     explicit RayCastHit( bool washit, const Vec2& hitPos, float finish );
+    explicit RayCastHit( bool washit, const Vec2& hitPos, float finish, const IntVec2& hitTile );
     //Tile* hitTile;
     //Entity* hitEntity;
-};
\ No newline at end of file
+};
+
+//-----------------------------------------------------------------------------
+// Walks RAYCAST_BATCH_LANES rays through the tile grid in lockstep with SSE2.
+// Tiles outside the bitmap block, matching the scalar Map raycasts.
+constexpr int RAYCAST_BATCH_LANES = 4;
+void RayCastTilesBatch( const TileBitmap& blockers,
+                        const Vec2* starts,
+                        const Vec2* directions,
+                        const float* maxDists,
+                        int numRays,
+                        RayCastHit* out_hits );
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "Shadowcast.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+#include "Game/FrameArena.hpp"
+#include "Game/Map/TileBitmap.hpp"
+
+namespace
+{
+    //-------------------------------------------------------------------------
+    // Slopes are kept as exact fractions so tiles on a shadow edge are
+    // classified the same way from either side
+    struct Slope
+    {
+        int numerator = 0;
+        int denominator = 1;
+    };
+
+    struct Quadrant
+    {
+        IntVec2 colAxis;
+        IntVec2 depthAxis;
+    };
+
+    const Quadrant QUADRANTS[ 4 ] = {
+        { IntVec2( 1, 0 ), IntVec2( 0, 1 ) },   // North
+        { IntVec2( 0, 1 ), IntVec2( 1, 0 ) },   // East
+        { IntVec2( 1, 0 ), IntVec2( 0, -1 ) },  // South
+        { IntVec2( 0, 1 ), IntVec2( -1, 0 ) },  // West
+    };
+
+    template<typename TILE_LIST>
+    struct ShadowcastContext
+    {
+        const TileBitmap& sightBlockers;
+        IntVec2 origin;
+        int maxTaxicabDistance;
+        TILE_LIST& visibleTiles;
+    };
+
+    int FloorDivide( int numerator, int denominator )
+    {
+        int quotient = numerator / denominator;
+        if( (numerator % denominator != 0) && ((numerator < 0) != (denominator < 0)) )
+        {
+            quotient -= 1;
+        }
+        return quotient;
+    }
+
+    // floor( depth * slope + 1/2 )
+    int RoundTiesUp( int depth, const Slope& slope )
+    {
+        return FloorDivide( 2 * depth * slope.numerator + slope.denominator, 2 * slope.denominator );
+    }
+
+    // ceil( depth * slope - 1/2 )
+    int RoundTiesDown( int depth, const Slope& slope )
+    {
+        return -FloorDivide( slope.denominator - 2 * depth * slope.numerator, 2 * slope.denominator );
+    }
+
+    // Slope to the edge of the tile that faces the start of the row
+    Slope GetTileEdgeSlope( int depth, int col )
+    {
+        Slope slope;
+        slope.numerator = 2 * col - 1;
+        slope.denominator = 2 * depth;
+        return slope;
+    }
+
+    bool IsSymmetric( int depth, int col, const Slope& startSlope, const Slope& endSlope )
+    {
+        return col * startSlope.denominator >= depth * startSlope.numerator &&
+               col * endSlope.denominator <= depth * endSlope.numerator;
+    }
+
+    template<typename TILE_LIST>
+    IntVec2 GetTilePosition( const ShadowcastContext<TILE_LIST>& context, const Quadrant& quadrant, int depth, int col )
+    {
+        return IntVec2( context.origin.x + quadrant.colAxis.x * col + quadrant.depthAxis.x * depth,
+                        context.origin.y + quadrant.colAxis.y * col + quadrant.depthAxis.y * depth );
+    }
+
+    template<typename TILE_LIST>
+    bool IsBlocking( const ShadowcastContext<TILE_LIST>& context, const IntVec2& tilePos )
+    {
+        if( !context.sightBlockers.IsInBounds( tilePos ) ) { return true; }
+        return context.sightBlockers.IsSet( tilePos );
+    }
+
+    template<typename TILE_LIST>
+    void RevealTile( ShadowcastContext<TILE_LIST>& context, const IntVec2& tilePos, int depth, int col )
+    {
+        if( !context.sightBlockers.IsInBounds( tilePos ) ) { return; }
+        if( depth + abs( col ) > context.maxTaxicabDistance ) { return; }
+
+        context.visibleTiles.push_back( tilePos );
+    }
+
+    template<typename TILE_LIST>
+    void ScanRow( ShadowcastContext<TILE_LIST>& context, const Quadrant& quadrant, int depth, Slope startSlope, Slope endSlope )
+    {
+        if( depth > context.maxTaxicabDistance ) { return; }
+
+        int minCol = RoundTiesUp( depth, startSlope );
+        int maxCol = RoundTiesDown( depth, endSlope );
+
+        bool hasPrevious = false;
+        bool wasPreviousBlocking = false;
+        for( int col = minCol; col <= maxCol; ++col )
+        {
+            IntVec2 tilePos = GetTilePosition( context, quadrant, depth, col );
+            bool isBlocking = IsBlocking( context, tilePos );
+
+            if( isBlocking || IsSymmetric( depth, col, startSlope, endSlope ) )
+            {
+                RevealTile( context, tilePos, depth, col );
+            }
+
+            if( hasPrevious && wasPreviousBlocking && !isBlocking )
+            {
+                startSlope = GetTileEdgeSlope( depth, col );
+            }
+            if( hasPrevious && !wasPreviousBlocking && isBlocking )
+            {
+                ScanRow( context, quadrant, depth + 1, startSlope, GetTileEdgeSlope( depth, col ) );
+            }
+
+            hasPrevious = true;
+            wasPreviousBlocking = isBlocking;
+        }
+
+        if( hasPrevious && !wasPreviousBlocking )
+        {
+            ScanRow( context, quadrant, depth + 1, startSlope, endSlope );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template<typename TILE_LIST>
+void ShadowcastVisibleTiles( const TileBitmap& sightBlockers,
+                             const IntVec2& origin,
+                             int maxTaxicabDistance,
+                             TILE_LIST& out_visibleTiles )
+{
+    if( !sightBlockers.IsInBounds( origin ) ) { return; }
+    out_visibleTiles.push_back( origin );
+
+    ShadowcastContext<TILE_LIST> context = { sightBlockers, origin, maxTaxicabDistance, out_visibleTiles };
+    for( int quadrantIndex = 0; quadrantIndex < 4; ++quadrantIndex )
+    {
+        Slope startSlope;
+        startSlope.numerator = -1;
+        Slope endSlope;
+        endSlope.numerator = 1;
+        ScanRow( context, QUADRANTS[ quadrantIndex ], 1, startSlope, endSlope );
+    }
+}
+
+
+template void ShadowcastVisibleTiles( const TileBitmap&, const IntVec2&, int, std::vector<IntVec2>& );
+template void ShadowcastVisibleTiles( const TileBitmap&, const IntVec2&, int, FrameVector<IntVec2>& );
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/IntVec2.hpp"
+
+class TileBitmap;
+
+//-----------------------------------------------------------------------------
+// Symmetric recursive shadowcasting. Appends every tile visible from origin
+// within maxTaxicabDistance, blocking tiles included. Tiles outside the
+// bitmap block sight and are never reported. TILE_LIST is a vector of
+// IntVec2, instantiated for std::vector and FrameVector in Shadowcast.cpp.
+template<typename TILE_LIST>
+void ShadowcastVisibleTiles( const TileBitmap& sightBlockers,
+                             const IntVec2& origin,
+                             int maxTaxicabDistance,
+                             TILE_LIST& out_visibleTiles );
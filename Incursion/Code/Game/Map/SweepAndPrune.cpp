@@ -0,0 +1,193 @@
+#include "SweepAndPrune.hpp"
+
+#include <algorithm>
+
+// The other axis has to spread this much further before the proxies are
+// resorted along it, so the sort axis doesn't flip back and forth
+constexpr float SWEEP_AND_PRUNE_AXIS_SWITCH_RATIO = 1.25f;
+
+//-----------------------------------------------------------------------------
+static bool IsEntityInSweepAndPrune( const Entity* entity )
+{
+    if( entity->IsDead() || entity->IsGarbage() ) { return false; }
+    return entity->OverlapsEntities();
+}
+
+//-----------------------------------------------------------------------------
+static float GetAxisValue( const Vec2& vec, int axis )
+{
+    return axis == 0 ? vec.x : vec.y;
+}
+
+//-----------------------------------------------------------------------------
+void SweepAndPrune::Update( const EntityList* entityLists, int numLists )
+{
+    RemoveStaleProxies( entityLists, numLists );
+    AddNewProxies( entityLists, numLists );
+    UpdateProxyBounds();
+    ChooseSortAxis();
+    InsertionSortProxies();
+}
+
+void SweepAndPrune::Clear()
+{
+    m_Proxies.clear();
+    m_ListSlotStarts.clear();
+    m_IsSlotTracked.clear();
+    m_NumSortSwaps = 0;
+}
+
+//-----------------------------------------------------------------------------
+void SweepAndPrune::GetPairs( std::vector<EntityGridPair>& out_pairs ) const
+{
+    int otherAxis = 1 - m_SortAxis;
+    int numProxies = static_cast<int>(m_Proxies.size());
+    for( int proxyIndex1 = 0; proxyIndex1 < numProxies; ++proxyIndex1 )
+    {
+        const Proxy& proxy1 = m_Proxies[ proxyIndex1 ];
+        float sweepEnd = GetAxisValue( proxy1.maxes, m_SortAxis );
+        for( int proxyIndex2 = proxyIndex1 + 1; proxyIndex2 < numProxies; ++proxyIndex2 )
+        {
+            const Proxy& proxy2 = m_Proxies[ proxyIndex2 ];
+            if( GetAxisValue( proxy2.mins, m_SortAxis ) > sweepEnd ) { break; }
+
+            if( GetAxisValue( proxy2.mins, otherAxis ) > GetAxisValue( proxy1.maxes, otherAxis ) ) { continue; }
+            if( GetAxisValue( proxy1.mins, otherAxis ) > GetAxisValue( proxy2.maxes, otherAxis ) ) { continue; }
+
+            EntityGridPair pair;
+            pair.first = proxy1.entry;
+            pair.second = proxy2.entry;
+            out_pairs.push_back( pair );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Drops proxies whose slot no longer holds a live entity, keeping the rest in
+// their sorted order
+void SweepAndPrune::RemoveStaleProxies( const EntityList* entityLists, int numLists )
+{
+    m_ListSlotStarts.resize( numLists + 1 );
+    m_ListSlotStarts[ 0 ] = 0;
+    for( int listIndex = 0; listIndex < numLists; ++listIndex )
+    {
+        m_ListSlotStarts[ listIndex + 1 ] = m_ListSlotStarts[ listIndex ] + static_cast<int>(entityLists[ listIndex ].data.size());
+    }
+    m_IsSlotTracked.assign( m_ListSlotStarts[ numLists ], 0 );
+
+    int numKept = 0;
+    for( int proxyIndex = 0; proxyIndex < m_Proxies.size(); ++proxyIndex )
+    {
+        const Proxy& proxy = m_Proxies[ proxyIndex ];
+        const EntityList& entityList = entityLists[ proxy.entry.listIndex ];
+        if( proxy.entry.entityIndex >= entityList.data.size() ) { continue; }
+
+        const Entity* entity = entityList.data[ proxy.entry.entityIndex ];
+        if( entity != proxy.entity || !IsEntityInSweepAndPrune( entity ) ) { continue; }
+
+        m_IsSlotTracked[ m_ListSlotStarts[ proxy.entry.listIndex ] + proxy.entry.entityIndex ] = 1;
+        m_Proxies[ numKept++ ] = proxy;
+    }
+    m_Proxies.resize( numKept );
+}
+
+//-----------------------------------------------------------------------------
+// New proxies go on the end, the insertion sort moves them into place
+void SweepAndPrune::AddNewProxies( const EntityList* entityLists, int numLists )
+{
+    for( int listIndex = 0; listIndex < numLists; ++listIndex )
+    {
+        const EntityList& entityList = entityLists[ listIndex ];
+        for( int entityIndex = 0; entityIndex < entityList.data.size(); ++entityIndex )
+        {
+            if( m_IsSlotTracked[ m_ListSlotStarts[ listIndex ] + entityIndex ] ) { continue; }
+
+            const Entity* entity = entityList.data[ entityIndex ];
+            if( !IsEntityInSweepAndPrune( entity ) ) { continue; }
+
+            Proxy proxy;
+            proxy.entry.listIndex = listIndex;
+            proxy.entry.entityIndex = entityIndex;
+            proxy.entity = entity;
+            m_Proxies.push_back( proxy );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Swept entities cover their whole path for the frame
+void SweepAndPrune::UpdateProxyBounds()
+{
+    for( int proxyIndex = 0; proxyIndex < m_Proxies.size(); ++proxyIndex )
+    {
+        Proxy& proxy = m_Proxies[ proxyIndex ];
+        Vec2 position = static_cast<Vec2>(proxy.entity->GetPosition());
+        Vec2 start = proxy.entity->UsesSweptCollision() ? static_cast<Vec2>(proxy.entity->GetPreviousPosition()) : position;
+        float radius = proxy.entity->GetPhysicsRadius();
+
+        proxy.mins = Vec2( std::min( start.x, position.x ) - radius, std::min( start.y, position.y ) - radius );
+        proxy.maxes = Vec2( std::max( start.x, position.x ) + radius, std::max( start.y, position.y ) + radius );
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Sorting on the axis with the most variance in centers keeps the runs of
+// proxies overlapping on the sort axis short
+void SweepAndPrune::ChooseSortAxis()
+{
+    int numProxies = static_cast<int>(m_Proxies.size());
+    if( numProxies < 2 ) { return; }
+
+    float sums[ 2 ] = { 0.f, 0.f };
+    float squaredSums[ 2 ] = { 0.f, 0.f };
+    for( int proxyIndex = 0; proxyIndex < numProxies; ++proxyIndex )
+    {
+        const Proxy& proxy = m_Proxies[ proxyIndex ];
+        for( int axis = 0; axis < 2; ++axis )
+        {
+            float center = .5f * (GetAxisValue( proxy.mins, axis ) + GetAxisValue( proxy.maxes, axis ));
+            sums[ axis ] += center;
+            squaredSums[ axis ] += center * center;
+        }
+    }
+
+    float variances[ 2 ];
+    for( int axis = 0; axis < 2; ++axis )
+    {
+        float mean = sums[ axis ] / numProxies;
+        variances[ axis ] = squaredSums[ axis ] / numProxies - mean * mean;
+    }
+
+    int otherAxis = 1 - m_SortAxis;
+    if( variances[ otherAxis ] > variances[ m_SortAxis ] * SWEEP_AND_PRUNE_AXIS_SWITCH_RATIO )
+    {
+        // Last frame's order says nothing about the new axis
+        m_SortAxis = otherAxis;
+        int sortAxis = m_SortAxis;
+        std::sort( m_Proxies.begin(), m_Proxies.end(), [sortAxis]( const Proxy& proxy1, const Proxy& proxy2 ) {
+            return GetAxisValue( proxy1.mins, sortAxis ) < GetAxisValue( proxy2.mins, sortAxis );
+        } );
+    }
+}
+
+//-----------------------------------------------------------------------------
+void SweepAndPrune::InsertionSortProxies()
+{
+    m_NumSortSwaps = 0;
+    int numProxies = static_cast<int>(m_Proxies.size());
+    for( int proxyIndex = 1; proxyIndex < numProxies; ++proxyIndex )
+    {
+        Proxy proxy = m_Proxies[ proxyIndex ];
+        float proxyMin = GetAxisValue( proxy.mins, m_SortAxis );
+
+        int insertIndex = proxyIndex;
+        while( insertIndex > 0 && GetAxisValue( m_Proxies[ insertIndex - 1 ].mins, m_SortAxis ) > proxyMin )
+        {
+            m_Proxies[ insertIndex ] = m_Proxies[ insertIndex - 1 ];
+            --insertIndex;
+        }
+
+        m_NumSortSwaps += proxyIndex - insertIndex;
+        m_Proxies[ insertIndex ] = proxy;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+
+#include "Game/Entity/Entity.hpp"
+#include "Game/Map/EntityGrid.hpp"
+
+//-----------------------------------------------------------------------------
+// Sweep and prune broadphase along whichever axis the entities spread out on
+// the most. Proxies stay sorted by their min edge between updates, and since
+// most entities barely move per frame the insertion sort that keeps them
+// sorted does little work.
+class SweepAndPrune
+{
+public:
+    void Update( const EntityList* entityLists, int numLists );
+    // Forgets every proxy, for when the entity lists are emptied
+    void Clear();
+    void GetPairs( std::vector<EntityGridPair>& out_pairs ) const;
+
+    int GetNumProxies() const           { return static_cast<int>(m_Proxies.size()); }
+    int GetSortAxis() const             { return m_SortAxis; }
+    int GetNumSortSwaps() const         { return m_NumSortSwaps; }
+
+private:
+    struct Proxy
+    {
+        EntityGridEntry entry;
+        const Entity* entity = nullptr;
+        Vec2 mins = Vec2::ZERO;
+        Vec2 maxes = Vec2::ZERO;
+    };
+    std::vector<Proxy> m_Proxies;
+    int m_SortAxis = 0;                 // 0 for x, 1 for y
+    int m_NumSortSwaps = 0;
+
+    // Which list slots already have a proxy, flattened per list
+    std::vector<int> m_ListSlotStarts;
+    std::vector<uint8_t> m_IsSlotTracked;
+
+    void RemoveStaleProxies( const EntityList* entityLists, int numLists );
+    void AddNewProxies( const EntityList* entityLists, int numLists );
+    void UpdateProxyBounds();
+    void ChooseSortAxis();
+    void InsertionSortProxies();
+};
\ No newline at end of file
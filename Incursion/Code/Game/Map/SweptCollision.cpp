@@ -0,0 +1,168 @@
+#include "SweptCollision.hpp"
+
+#include <cmath>
+
+#include "Game/Map/TileBitmap.hpp"
+
+//-----------------------------------------------------------------------------
+// Smallest t in [0, 1] where start + t * displacement is radius from center
+static bool SweepPointVsCircle( const Vec2& start,
+                                const Vec2& displacement,
+                                const Vec2& center,
+                                float radius,
+                                float& out_hitTime )
+{
+    Vec2 fromCenter = Vec2( start.x - center.x, start.y - center.y );
+    float c = fromCenter.x * fromCenter.x + fromCenter.y * fromCenter.y - radius * radius;
+    if( c <= 0.f )
+    {
+        out_hitTime = 0.f;
+        return true;
+    }
+
+    float a = displacement.x * displacement.x + displacement.y * displacement.y;
+    if( a == 0.f ) { return false; }
+
+    float b = 2.f * (displacement.x * fromCenter.x + displacement.y * fromCenter.y);
+    if( b >= 0.f ) { return false; }
+
+    float discriminant = b * b - 4.f * a * c;
+    if( discriminant < 0.f ) { return false; }
+
+    float hitTime = (-b - sqrtf( discriminant )) / (2.f * a);
+    if( hitTime > 1.f ) { return false; }
+
+    out_hitTime = hitTime;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// Slab test of a moving point against a box, entry time only
+static bool SweepPointVsBox( const Vec2& start,
+                             const Vec2& displacement,
+                             const Vec2& boxMins,
+                             const Vec2& boxMaxes,
+                             float& out_hitTime )
+{
+    float enterTime = 0.f;
+    float exitTime = 1.f;
+
+    const float starts[ 2 ] = { start.x, start.y };
+    const float deltas[ 2 ] = { displacement.x, displacement.y };
+    const float mins[ 2 ] = { boxMins.x, boxMins.y };
+    const float maxes[ 2 ] = { boxMaxes.x, boxMaxes.y };
+    for( int axis = 0; axis < 2; ++axis )
+    {
+        if( deltas[ axis ] == 0.f )
+        {
+            if( starts[ axis ] < mins[ axis ] || starts[ axis ] > maxes[ axis ] ) { return false; }
+            continue;
+        }
+
+        float nearTime = (mins[ axis ] - starts[ axis ]) / deltas[ axis ];
+        float farTime = (maxes[ axis ] - starts[ axis ]) / deltas[ axis ];
+        if( nearTime > farTime )
+        {
+            float swap = nearTime;
+            nearTime = farTime;
+            farTime = swap;
+        }
+        if( nearTime > enterTime ) { enterTime = nearTime; }
+        if( farTime < exitTime ) { exitTime = farTime; }
+        if( enterTime > exitTime ) { return false; }
+    }
+
+    out_hitTime = enterTime;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SweepDiscVsDisc( const Vec2& start,
+                      const Vec2& end,
+                      float radius,
+                      const Vec2& otherCenter,
+                      float otherRadius,
+                      float& out_hitTime )
+{
+    Vec2 displacement = Vec2( end.x - start.x, end.y - start.y );
+    return SweepPointVsCircle( start, displacement, otherCenter, radius + otherRadius, out_hitTime );
+}
+
+//-----------------------------------------------------------------------------
+// The disc's center hits the box grown by radius, which is the union of the
+// box grown along each axis and a circle at each corner
+bool SweepDiscVsAABB2( const Vec2& start,
+                       const Vec2& end,
+                       float radius,
+                       const AABB2& box,
+                       float& out_hitTime )
+{
+    Vec2 displacement = Vec2( end.x - start.x, end.y - start.y );
+
+    bool didHit = false;
+    float earliestTime = 1.f;
+    float hitTime = 0.f;
+
+    if( SweepPointVsBox( start, displacement, Vec2( box.mins.x - radius, box.mins.y ), Vec2( box.maxes.x + radius, box.maxes.y ), hitTime ) &&
+        hitTime <= earliestTime )
+    {
+        earliestTime = hitTime;
+        didHit = true;
+    }
+    if( SweepPointVsBox( start, displacement, Vec2( box.mins.x, box.mins.y - radius ), Vec2( box.maxes.x, box.maxes.y + radius ), hitTime ) &&
+        hitTime <= earliestTime )
+    {
+        earliestTime = hitTime;
+        didHit = true;
+    }
+
+    const Vec2 corners[ 4 ] = { box.mins, Vec2( box.maxes.x, box.mins.y ), box.maxes, Vec2( box.mins.x, box.maxes.y ) };
+    for( int cornerIndex = 0; cornerIndex < 4; ++cornerIndex )
+    {
+        if( SweepPointVsCircle( start, displacement, corners[ cornerIndex ], radius, hitTime ) &&
+            hitTime <= earliestTime )
+        {
+            earliestTime = hitTime;
+            didHit = true;
+        }
+    }
+
+    if( didHit ) { out_hitTime = earliestTime; }
+    return didHit;
+}
+
+//-----------------------------------------------------------------------------
+bool SweepDiscVsTiles( const TileBitmap& blockers,
+                       const Vec2& start,
+                       const Vec2& end,
+                       float radius,
+                       float& out_hitTime )
+{
+    int minTileX = static_cast<int>(floorf( fminf( start.x, end.x ) - radius ));
+    int minTileY = static_cast<int>(floorf( fminf( start.y, end.y ) - radius ));
+    int maxTileX = static_cast<int>(floorf( fmaxf( start.x, end.x ) + radius ));
+    int maxTileY = static_cast<int>(floorf( fmaxf( start.y, end.y ) + radius ));
+
+    bool didHit = false;
+    float earliestTime = 1.f;
+    for( int tileY = minTileY; tileY <= maxTileY; ++tileY )
+    {
+        for( int tileX = minTileX; tileX <= maxTileX; ++tileX )
+        {
+            IntVec2 tilePos = IntVec2( tileX, tileY );
+            if( !blockers.IsInBounds( tilePos ) || !blockers.IsSet( tilePos ) ) { continue; }
+
+            AABB2 tileBounds = AABB2( Vec2( static_cast<float>(tileX), static_cast<float>(tileY) ),
+                                      Vec2( static_cast<float>(tileX + 1), static_cast<float>(tileY + 1) ) );
+            float hitTime = 0.f;
+            if( SweepDiscVsAABB2( start, end, radius, tileBounds, hitTime ) && hitTime <= earliestTime )
+            {
+                earliestTime = hitTime;
+                didHit = true;
+            }
+        }
+    }
+
+    if( didHit ) { out_hitTime = earliestTime; }
+    return didHit;
+}
\ No newline at end of file
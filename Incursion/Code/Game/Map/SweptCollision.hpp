@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Engine/Core/Math/Primatives/AABB2.hpp"
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+
+class TileBitmap;
+
+//-----------------------------------------------------------------------------
+// Continuous tests for a disc moving from start to end. out_hitTime is the
+// fraction of the move at first contact, 0 when the disc starts overlapping.
+bool SweepDiscVsDisc( const Vec2& start,
+                      const Vec2& end,
+                      float radius,
+                      const Vec2& otherCenter,
+                      float otherRadius,
+                      float& out_hitTime );
+bool SweepDiscVsAABB2( const Vec2& start,
+                       const Vec2& end,
+                       float radius,
+                       const AABB2& box,
+                       float& out_hitTime );
+
+// Earliest contact with any set tile in the bitmap, tiles off the map are open
+bool SweepDiscVsTiles( const TileBitmap& blockers,
+                       const Vec2& start,
+                       const Vec2& end,
+                       float radius,
+                       float& out_hitTime );
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "TileBitmap.hpp"
+
+#include <algorithm>
+
+constexpr int BITS_PER_WORD = 64;
+constexpr int WORD_SHIFT = 6;
+constexpr int BIT_MASK = BITS_PER_WORD - 1;
+
+void TileBitmap::Resize( const IntVec2& size )
+{
+    m_Size = size;
+    m_WordsPerRow = (size.x + BIT_MASK) >> WORD_SHIFT;
+    m_Words.assign( static_cast<size_t>(m_WordsPerRow) * static_cast<size_t>(size.y), 0 );
+}
+
+void TileBitmap::Clear()
+{
+    std::fill( m_Words.begin(), m_Words.end(), 0 );
+}
+
+bool TileBitmap::IsInBounds( const IntVec2& tilePos ) const
+{
+    return tilePos.x >= 0 && tilePos.y >= 0 && tilePos.x < m_Size.x && tilePos.y < m_Size.y;
+}
+
+bool TileBitmap::IsSet( const IntVec2& tilePos ) const
+{
+    uint64_t word = m_Words[ tilePos.y * m_WordsPerRow + (tilePos.x >> WORD_SHIFT) ];
+    return ((word >> (tilePos.x & BIT_MASK)) & 1) != 0;
+}
+
+bool TileBitmap::IsAnySetInRow( int row, int minX, int maxX ) const
+{
+    const uint64_t* rowWords = GetRow( row );
+    int minWord = minX >> WORD_SHIFT;
+    int maxWord = maxX >> WORD_SHIFT;
+
+    for( int wordIndex = minWord; wordIndex <= maxWord; ++wordIndex )
+    {
+        uint64_t mask = ~0ull;
+        if( wordIndex == minWord ) { mask &= ~0ull << (minX & BIT_MASK); }
+        if( wordIndex == maxWord ) { mask &= ~0ull >> (BIT_MASK - (maxX & BIT_MASK)); }
+
+        if( (rowWords[ wordIndex ] & mask) != 0 ) { return true; }
+    }
+    return false;
+}
+
+bool TileBitmap::IsAnySetInBox( const IntVec2& minTile, const IntVec2& maxTile ) const
+{
+    for( int row = minTile.y; row <= maxTile.y; ++row )
+    {
+        if( IsAnySetInRow( row, minTile.x, maxTile.x ) ) { return true; }
+    }
+    return false;
+}
+
+const uint64_t* TileBitmap::GetRow( int row ) const
+{
+    return &m_Words[ row * m_WordsPerRow ];
+}
+
+void TileBitmap::Set( const IntVec2& tilePos, bool isSet )
+{
+    uint64_t& word = m_Words[ tilePos.y * m_WordsPerRow + (tilePos.x >> WORD_SHIFT) ];
+    uint64_t bit = 1ull << (tilePos.x & BIT_MASK);
+    if( isSet )
+    {
+        word |= bit;
+    }
+    else
+    {
+        word &= ~bit;
+    }
+}
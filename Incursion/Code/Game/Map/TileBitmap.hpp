@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/IntVec2.hpp"
+
+//-----------------------------------------------------------------------------
+// One bit per tile, rows padded to whole 64 bit words so a row can be tested
+// 64 tiles at a time
+class TileBitmap
+{
+public:
+    void Resize( const IntVec2& size );
+    void Clear();
+
+    const IntVec2& GetSize() const { return m_Size; }
+    bool IsInBounds( const IntVec2& tilePos ) const;
+    bool IsSet( const IntVec2& tilePos ) const;
+    bool IsAnySetInRow( int row, int minX, int maxX ) const;
+    bool IsAnySetInBox( const IntVec2& minTile, const IntVec2& maxTile ) const;
+    const uint64_t* GetRow( int row ) const;
+    int GetWordsPerRow() const { return m_WordsPerRow; }
+
+    void Set( const IntVec2& tilePos, bool isSet );
+
+private:
+    IntVec2 m_Size = IntVec2::ZERO;
+    int m_WordsPerRow = 0;
+    std::vector<uint64_t> m_Words;
+};
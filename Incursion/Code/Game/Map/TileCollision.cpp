@@ -0,0 +1,165 @@
+#include "TileCollision.hpp"
+
+#include <cmath>
+#include <emmintrin.h>
+
+#include "Game/Map/TileBitmap.hpp"
+
+const IntVec2 TILE_NEIGHBOR_OFFSETS[ NUM_TILE_NEIGHBORS ] = {
+    IntVec2( 0, -1 ),
+    IntVec2( 1, 0 ),
+    IntVec2( 0, 1 ),
+    IntVec2( -1, 0 ),
+    IntVec2( -1, -1 ),
+    IntVec2( 1, -1 ),
+    IntVec2( 1, 1 ),
+    IntVec2( -1, 1 ),
+};
+
+//-----------------------------------------------------------------------------
+void TileNeighborMasks::Build( const TileBitmap& tiles )
+{
+    m_Size = tiles.GetSize();
+    m_Masks.assign( m_Size.x * m_Size.y, 0 );
+    for( int tileY = 0; tileY < m_Size.y; ++tileY )
+    {
+        for( int tileX = 0; tileX < m_Size.x; ++tileX )
+        {
+            m_Masks[ tileY * m_Size.x + tileX ] = ComputeMask( tiles, IntVec2( tileX, tileY ) );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Only the changed tile's neighbors see it in their masks
+void TileNeighborMasks::UpdateAroundTile( const TileBitmap& tiles, const IntVec2& changedTile )
+{
+    for( int neighborIndex = 0; neighborIndex < NUM_TILE_NEIGHBORS; ++neighborIndex )
+    {
+        IntVec2 tilePos = changedTile + TILE_NEIGHBOR_OFFSETS[ neighborIndex ];
+        if( !tiles.IsInBounds( tilePos ) ) { continue; }
+
+        m_Masks[ tilePos.y * m_Size.x + tilePos.x ] = ComputeMask( tiles, tilePos );
+    }
+}
+
+//-----------------------------------------------------------------------------
+uint8_t TileNeighborMasks::GetMask( const IntVec2& tilePos ) const
+{
+    if( tilePos.x < 0 || tilePos.y < 0 || tilePos.x >= m_Size.x || tilePos.y >= m_Size.y ) { return 0; }
+    return m_Masks[ tilePos.y * m_Size.x + tilePos.x ];
+}
+
+//-----------------------------------------------------------------------------
+uint8_t TileNeighborMasks::ComputeMask( const TileBitmap& tiles, const IntVec2& tilePos )
+{
+    uint8_t mask = 0;
+    for( int neighborIndex = 0; neighborIndex < NUM_TILE_NEIGHBORS; ++neighborIndex )
+    {
+        IntVec2 neighborPos = tilePos + TILE_NEIGHBOR_OFFSETS[ neighborIndex ];
+        if( tiles.IsInBounds( neighborPos ) && tiles.IsSet( neighborPos ) )
+        {
+            mask |= static_cast<uint8_t>(1 << neighborIndex);
+        }
+    }
+    return mask;
+}
+
+//-----------------------------------------------------------------------------
+// Each lane is one disc, every lane steps through the 8 neighbors together
+// and only moves when its mask has the neighbor and the disc overlaps it
+static void PushDiscsOutOfNeighborTilesLanes( Vec2* centers,
+                                              const float* radii,
+                                              const IntVec2* tilePositions,
+                                              const uint8_t* neighborMasks,
+                                              int numLanes )
+{
+    alignas(16) float centerX[ TILE_COLLISION_BATCH_LANES ] = {};
+    alignas(16) float centerY[ TILE_COLLISION_BATCH_LANES ] = {};
+    alignas(16) float radius[ TILE_COLLISION_BATCH_LANES ] = {};
+    alignas(16) float tileX[ TILE_COLLISION_BATCH_LANES ] = {};
+    alignas(16) float tileY[ TILE_COLLISION_BATCH_LANES ] = {};
+    alignas(16) int laneMasks[ TILE_COLLISION_BATCH_LANES ] = {};
+    for( int lane = 0; lane < numLanes; ++lane )
+    {
+        centerX[ lane ] = centers[ lane ].x;
+        centerY[ lane ] = centers[ lane ].y;
+        radius[ lane ] = radii[ lane ];
+        tileX[ lane ] = static_cast<float>(tilePositions[ lane ].x);
+        tileY[ lane ] = static_cast<float>(tilePositions[ lane ].y);
+        laneMasks[ lane ] = neighborMasks[ lane ];
+    }
+
+    __m128 centerXLanes = _mm_load_ps( centerX );
+    __m128 centerYLanes = _mm_load_ps( centerY );
+    const __m128 radiusLanes = _mm_load_ps( radius );
+    const __m128 radiusSquaredLanes = _mm_mul_ps( radiusLanes, radiusLanes );
+    const __m128 tileXLanes = _mm_load_ps( tileX );
+    const __m128 tileYLanes = _mm_load_ps( tileY );
+    const __m128i maskLanes = _mm_load_si128( reinterpret_cast<const __m128i*>(laneMasks) );
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.f );
+
+    for( int neighborIndex = 0; neighborIndex < NUM_TILE_NEIGHBORS; ++neighborIndex )
+    {
+        const IntVec2& offset = TILE_NEIGHBOR_OFFSETS[ neighborIndex ];
+        __m128i neighborBit = _mm_set1_epi32( 1 << neighborIndex );
+        __m128 hasNeighbor = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( maskLanes, neighborBit ), neighborBit ) );
+        if( _mm_movemask_ps( hasNeighbor ) == 0 ) { continue; }
+
+        // Closest point on the neighbor tile to each center
+        __m128 boxMinX = _mm_add_ps( tileXLanes, _mm_set1_ps( static_cast<float>(offset.x) ) );
+        __m128 boxMinY = _mm_add_ps( tileYLanes, _mm_set1_ps( static_cast<float>(offset.y) ) );
+        __m128 closestX = _mm_min_ps( _mm_max_ps( centerXLanes, boxMinX ), _mm_add_ps( boxMinX, one ) );
+        __m128 closestY = _mm_min_ps( _mm_max_ps( centerYLanes, boxMinY ), _mm_add_ps( boxMinY, one ) );
+
+        __m128 deltaX = _mm_sub_ps( centerXLanes, closestX );
+        __m128 deltaY = _mm_sub_ps( centerYLanes, closestY );
+        __m128 distSquared = _mm_add_ps( _mm_mul_ps( deltaX, deltaX ), _mm_mul_ps( deltaY, deltaY ) );
+        __m128 isOverlapping = _mm_and_ps( hasNeighbor, _mm_cmplt_ps( distSquared, radiusSquaredLanes ) );
+        if( _mm_movemask_ps( isOverlapping ) == 0 ) { continue; }
+
+        // A center right on the tile edge has no direction of its own, push
+        // it straight away from the neighbor instead
+        __m128 isOnEdge = _mm_cmpeq_ps( distSquared, zero );
+        const float offsetLength = sqrtf( static_cast<float>(offset.x * offset.x + offset.y * offset.y) );
+        __m128 awayX = _mm_set1_ps( -offset.x / offsetLength );
+        __m128 awayY = _mm_set1_ps( -offset.y / offsetLength );
+
+        __m128 dist = _mm_sqrt_ps( _mm_or_ps( _mm_andnot_ps( isOnEdge, distSquared ), _mm_and_ps( isOnEdge, one ) ) );
+        __m128 pushDirX = _mm_or_ps( _mm_andnot_ps( isOnEdge, _mm_div_ps( deltaX, dist ) ), _mm_and_ps( isOnEdge, awayX ) );
+        __m128 pushDirY = _mm_or_ps( _mm_andnot_ps( isOnEdge, _mm_div_ps( deltaY, dist ) ), _mm_and_ps( isOnEdge, awayY ) );
+
+        __m128 pushedX = _mm_add_ps( closestX, _mm_mul_ps( pushDirX, radiusLanes ) );
+        __m128 pushedY = _mm_add_ps( closestY, _mm_mul_ps( pushDirY, radiusLanes ) );
+        centerXLanes = _mm_or_ps( _mm_and_ps( isOverlapping, pushedX ), _mm_andnot_ps( isOverlapping, centerXLanes ) );
+        centerYLanes = _mm_or_ps( _mm_and_ps( isOverlapping, pushedY ), _mm_andnot_ps( isOverlapping, centerYLanes ) );
+    }
+
+    _mm_store_ps( centerX, centerXLanes );
+    _mm_store_ps( centerY, centerYLanes );
+    for( int lane = 0; lane < numLanes; ++lane )
+    {
+        centers[ lane ] = Vec2( centerX[ lane ], centerY[ lane ] );
+    }
+}
+
+//-----------------------------------------------------------------------------
+void PushDiscsOutOfNeighborTiles( Vec2* centers,
+                                  const float* radii,
+                                  const IntVec2* tilePositions,
+                                  const uint8_t* neighborMasks,
+                                  int numDiscs )
+{
+    for( int firstDisc = 0; firstDisc < numDiscs; firstDisc += TILE_COLLISION_BATCH_LANES )
+    {
+        int numLanes = numDiscs - firstDisc;
+        if( numLanes > TILE_COLLISION_BATCH_LANES ) { numLanes = TILE_COLLISION_BATCH_LANES; }
+
+        PushDiscsOutOfNeighborTilesLanes( centers + firstDisc,
+                                          radii + firstDisc,
+                                          tilePositions + firstDisc,
+                                          neighborMasks + firstDisc,
+                                          numLanes );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/IntVec2.hpp"
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+
+class TileBitmap;
+
+// Edge neighbors come before corners, so a disc is pushed off walls before
+// the corners between them
+constexpr int NUM_TILE_NEIGHBORS = 8;
+extern const IntVec2 TILE_NEIGHBOR_OFFSETS[ NUM_TILE_NEIGHBORS ];
+
+constexpr int TILE_COLLISION_BATCH_LANES = 4;
+
+//-----------------------------------------------------------------------------
+// Per tile bit mask of which of its 8 neighbors are set in a tile bitmap,
+// bit i for TILE_NEIGHBOR_OFFSETS[ i ]. Neighbors off the map are clear.
+class TileNeighborMasks
+{
+public:
+    void Build( const TileBitmap& tiles );
+    void UpdateAroundTile( const TileBitmap& tiles, const IntVec2& changedTile );
+
+    uint8_t GetMask( const IntVec2& tilePos ) const;
+
+private:
+    IntVec2 m_Size = IntVec2::ZERO;
+    std::vector<uint8_t> m_Masks;
+
+    static uint8_t ComputeMask( const TileBitmap& tiles, const IntVec2& tilePos );
+};
+
+//-----------------------------------------------------------------------------
+// Pushes each disc out of every neighbor tile set in its mask, in neighbor
+// order. tilePositions is the tile each disc's center is in, the center tile
+// itself is not tested. Discs run TILE_COLLISION_BATCH_LANES at a time.
+void PushDiscsOutOfNeighborTiles( Vec2* centers,
+                                  const float* radii,
+                                  const IntVec2* tilePositions,
+                                  const uint8_t* neighborMasks,
+                                  int numDiscs );
\ No newline at end of file
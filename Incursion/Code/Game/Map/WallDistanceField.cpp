@@ -0,0 +1,221 @@
+#include "WallDistanceField.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "Game/Map/TileBitmap.hpp"
+
+namespace
+{
+    constexpr float NO_SOLID = std::numeric_limits<float>::infinity();
+
+    //-------------------------------------------------------------------------
+    // Felzenszwalb-Huttenlocher lower envelope of parabolas, squared
+    // distances in and out
+    void DistanceTransform1D( const std::vector<float>& squaredIn,
+                              std::vector<float>& out_squared,
+                              std::vector<int>& parabolaSites,
+                              std::vector<float>& parabolaBounds )
+    {
+        int count = static_cast<int>(squaredIn.size());
+        parabolaSites.resize( count );
+        parabolaBounds.resize( count + 1 );
+        out_squared.resize( count );
+
+        int numParabolas = 0;
+        for( int site = 0; site < count; ++site )
+        {
+            if( squaredIn[ site ] == NO_SOLID ) { continue; }
+
+            float intersection = -NO_SOLID;
+            while( numParabolas > 0 )
+            {
+                int lastSite = parabolaSites[ numParabolas - 1 ];
+                intersection = ((squaredIn[ site ] + site * site) - (squaredIn[ lastSite ] + lastSite * lastSite)) /
+                               (2.f * (site - lastSite));
+                if( intersection > parabolaBounds[ numParabolas - 1 ] ) { break; }
+                --numParabolas;
+            }
+
+            parabolaSites[ numParabolas ] = site;
+            parabolaBounds[ numParabolas ] = intersection;
+            ++numParabolas;
+        }
+
+        if( numParabolas == 0 )
+        {
+            for( int index = 0; index < count; ++index ) { out_squared[ index ] = NO_SOLID; }
+            return;
+        }
+
+        parabolaBounds[ numParabolas ] = NO_SOLID;
+        int parabolaIndex = 0;
+        for( int index = 0; index < count; ++index )
+        {
+            while( parabolaBounds[ parabolaIndex + 1 ] < index ) { ++parabolaIndex; }
+            int site = parabolaSites[ parabolaIndex ];
+            float offset = static_cast<float>(index - site);
+            out_squared[ index ] = offset * offset + squaredIn[ site ];
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Runs on a grid padded by one solid tile on every side so the map edge
+// counts as wall
+void WallDistanceField::Build( const TileBitmap& solids, float maxDistance )
+{
+    m_Size = solids.GetSize();
+    m_MaxDistance = maxDistance;
+
+    int paddedWidth = m_Size.x + 2;
+    int paddedHeight = m_Size.y + 2;
+    std::vector<float> squaredDistances( paddedWidth * paddedHeight, NO_SOLID );
+    for( int paddedY = 0; paddedY < paddedHeight; ++paddedY )
+    {
+        for( int paddedX = 0; paddedX < paddedWidth; ++paddedX )
+        {
+            IntVec2 tilePos = IntVec2( paddedX - 1, paddedY - 1 );
+            if( !solids.IsInBounds( tilePos ) || solids.IsSet( tilePos ) )
+            {
+                squaredDistances[ paddedY * paddedWidth + paddedX ] = 0.f;
+            }
+        }
+    }
+
+    std::vector<float> lineIn;
+    std::vector<float> lineOut;
+    std::vector<int> parabolaSites;
+    std::vector<float> parabolaBounds;
+
+    lineIn.resize( paddedHeight );
+    for( int paddedX = 0; paddedX < paddedWidth; ++paddedX )
+    {
+        for( int paddedY = 0; paddedY < paddedHeight; ++paddedY )
+        {
+            lineIn[ paddedY ] = squaredDistances[ paddedY * paddedWidth + paddedX ];
+        }
+        DistanceTransform1D( lineIn, lineOut, parabolaSites, parabolaBounds );
+        for( int paddedY = 0; paddedY < paddedHeight; ++paddedY )
+        {
+            squaredDistances[ paddedY * paddedWidth + paddedX ] = lineOut[ paddedY ];
+        }
+    }
+
+    lineIn.resize( paddedWidth );
+    for( int paddedY = 0; paddedY < paddedHeight; ++paddedY )
+    {
+        for( int paddedX = 0; paddedX < paddedWidth; ++paddedX )
+        {
+            lineIn[ paddedX ] = squaredDistances[ paddedY * paddedWidth + paddedX ];
+        }
+        DistanceTransform1D( lineIn, lineOut, parabolaSites, parabolaBounds );
+        for( int paddedX = 0; paddedX < paddedWidth; ++paddedX )
+        {
+            squaredDistances[ paddedY * paddedWidth + paddedX ] = lineOut[ paddedX ];
+        }
+    }
+
+    m_Distances.resize( m_Size.x * m_Size.y );
+    for( int tileY = 0; tileY < m_Size.y; ++tileY )
+    {
+        for( int tileX = 0; tileX < m_Size.x; ++tileX )
+        {
+            float distance = sqrtf( squaredDistances[ (tileY + 1) * paddedWidth + (tileX + 1) ] );
+            m_Distances[ tileY * m_Size.x + tileX ] = distance < maxDistance ? distance : maxDistance;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Distances are capped, so only tiles within the cap of the changed tile can
+// move and each only has to look that far for a solid
+void WallDistanceField::UpdateAroundTile( const TileBitmap& solids, const IntVec2& changedTile )
+{
+    int reach = static_cast<int>(ceilf( m_MaxDistance ));
+    for( int tileY = changedTile.y - reach; tileY <= changedTile.y + reach; ++tileY )
+    {
+        for( int tileX = changedTile.x - reach; tileX <= changedTile.x + reach; ++tileX )
+        {
+            if( !solids.IsInBounds( IntVec2( tileX, tileY ) ) ) { continue; }
+
+            float nearestSquared = m_MaxDistance * m_MaxDistance;
+            for( int solidY = tileY - reach; solidY <= tileY + reach; ++solidY )
+            {
+                for( int solidX = tileX - reach; solidX <= tileX + reach; ++solidX )
+                {
+                    IntVec2 solidPos = IntVec2( solidX, solidY );
+                    if( solids.IsInBounds( solidPos ) && !solids.IsSet( solidPos ) ) { continue; }
+
+                    float offsetX = static_cast<float>(solidX - tileX);
+                    float offsetY = static_cast<float>(solidY - tileY);
+                    float squared = offsetX * offsetX + offsetY * offsetY;
+                    if( squared < nearestSquared ) { nearestSquared = squared; }
+                }
+            }
+            m_Distances[ tileY * m_Size.x + tileX ] = sqrtf( nearestSquared );
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+float WallDistanceField::GetDistanceAtTile( const IntVec2& tilePos ) const
+{
+    return GetClampedDistance( tilePos.x, tilePos.y );
+}
+
+//-----------------------------------------------------------------------------
+float WallDistanceField::SampleDistance( const Vec2& point ) const
+{
+    // Center to center distance, the wall surface is half a tile closer
+    float surfaceDistance = SampleCenterDistance( point ) - .5f;
+    return surfaceDistance > 0.f ? surfaceDistance : 0.f;
+}
+
+//-----------------------------------------------------------------------------
+Vec2 WallDistanceField::SampleNormal( const Vec2& point ) const
+{
+    // Half a tile either side spans the kink at each tile center
+    constexpr float STEP = .5f;
+    Vec2 gradient = Vec2( SampleCenterDistance( point + Vec2( STEP, 0.f ) ) - SampleCenterDistance( point - Vec2( STEP, 0.f ) ),
+                          SampleCenterDistance( point + Vec2( 0.f, STEP ) ) - SampleCenterDistance( point - Vec2( 0.f, STEP ) ) );
+    if( gradient.x == 0.f && gradient.y == 0.f ) { return Vec2::ZERO; }
+
+    return gradient.GetNormalized();
+}
+
+//-----------------------------------------------------------------------------
+float WallDistanceField::GetClampedDistance( int tileX, int tileY ) const
+{
+    if( tileX < 0 || tileY < 0 || tileX >= m_Size.x || tileY >= m_Size.y ) { return 0.f; }
+    return m_Distances[ tileY * m_Size.x + tileX ];
+}
+
+//-----------------------------------------------------------------------------
+float WallDistanceField::SampleCenterDistance( const Vec2& point ) const
+{
+    int tileX = 0;
+    int tileY = 0;
+    float fractionX = 0.f;
+    float fractionY = 0.f;
+    GetBilinearCorners( point, tileX, tileY, fractionX, fractionY );
+
+    float bottom = GetClampedDistance( tileX, tileY ) * (1.f - fractionX) + GetClampedDistance( tileX + 1, tileY ) * fractionX;
+    float top = GetClampedDistance( tileX, tileY + 1 ) * (1.f - fractionX) + GetClampedDistance( tileX + 1, tileY + 1 ) * fractionX;
+    return bottom * (1.f - fractionY) + top * fractionY;
+}
+
+//-----------------------------------------------------------------------------
+void WallDistanceField::GetBilinearCorners( const Vec2& point,
+                                            int& out_tileX,
+                                            int& out_tileY,
+                                            float& out_fractionX,
+                                            float& out_fractionY ) const
+{
+    float fromCenterX = point.x - .5f;
+    float fromCenterY = point.y - .5f;
+    out_tileX = static_cast<int>(floorf( fromCenterX ));
+    out_tileY = static_cast<int>(floorf( fromCenterY ));
+    out_fractionX = fromCenterX - static_cast<float>(out_tileX);
+    out_fractionY = fromCenterY - static_cast<float>(out_tileY);
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "Engine/Core/Math/Primatives/IntVec2.hpp"
+#include "Engine/Core/Math/Primatives/Vec2.hpp"
+
+class TileBitmap;
+
+//-----------------------------------------------------------------------------
+// Distance from each tile center to the nearest solid tile center, capped at
+// maxDistance. Tiles off the map count as solid. Samples between tile
+// centers are bilinear, and normals are central differences of those
+// samples so they point away from the nearest wall without jumping at tile
+// centers.
+class WallDistanceField
+{
+public:
+    void Build( const TileBitmap& solids, float maxDistance );
+    void UpdateAroundTile( const TileBitmap& solids, const IntVec2& changedTile );
+
+    float GetMaxDistance() const { return m_MaxDistance; }
+    float GetDistanceAtTile( const IntVec2& tilePos ) const;
+
+    // Approximate distance from point to the nearest wall surface
+    float SampleDistance( const Vec2& point ) const;
+    Vec2 SampleNormal( const Vec2& point ) const;
+
+private:
+    IntVec2 m_Size = IntVec2::ZERO;
+    float m_MaxDistance = 0.f;
+    std::vector<float> m_Distances;
+
+    float GetClampedDistance( int tileX, int tileY ) const;
+    float SampleCenterDistance( const Vec2& point ) const;
+    void GetBilinearCorners( const Vec2& point,
+                             int& out_tileX, 
+                             int& out_tileY, 
+                             float& out_fractionX, 
+                             float& out_fractionY ) const;
+};
\ No newline at end of file
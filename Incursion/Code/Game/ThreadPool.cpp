@@ -0,0 +1,101 @@
+#include "ThreadPool.hpp"
+
+static thread_local int t_ThreadIndex = 0;
+
+//-----------------------------------------------------------------------------
+ThreadPool::ThreadPool( int numWorkers )
+    : m_NextIndex( 0 )
+{
+    for( int workerIndex = 0; workerIndex < numWorkers; ++workerIndex )
+    {
+        m_Workers.emplace_back( &ThreadPool::WorkerMain, this, workerIndex + 1 );
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_Mutex );
+        m_IsShuttingDown = true;
+    }
+    m_WorkReady.notify_all();
+
+    for( int workerIndex = 0; workerIndex < m_Workers.size(); ++workerIndex )
+    {
+        m_Workers[ workerIndex ].join();
+    }
+}
+
+int ThreadPool::GetCurrentThreadIndex()
+{
+    return t_ThreadIndex;
+}
+
+//-----------------------------------------------------------------------------
+void ThreadPool::ParallelFor( int count, const std::function<void( int )>& job )
+{
+    if( count <= 0 ) { return; }
+    if( m_Workers.empty() || count == 1 )
+    {
+        for( int index = 0; index < count; ++index )
+        {
+            job( index );
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_Mutex );
+        m_Job = &job;
+        m_JobCount = count;
+        m_NextIndex = 0;
+        m_NumBusyWorkers = static_cast<int>(m_Workers.size());
+        ++m_Generation;
+    }
+    m_WorkReady.notify_all();
+
+    RunJobIndices();
+
+    // Every worker has to check in before the job can go out of scope
+    std::unique_lock<std::mutex> lock( m_Mutex );
+    m_WorkDone.wait( lock, [this]() { return m_NumBusyWorkers == 0; } );
+    m_Job = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void ThreadPool::WorkerMain( int threadIndex )
+{
+    t_ThreadIndex = threadIndex;
+
+    int lastGeneration = 0;
+    for( ;; )
+    {
+        {
+            std::unique_lock<std::mutex> lock( m_Mutex );
+            m_WorkReady.wait( lock, [this, lastGeneration]() { return m_IsShuttingDown || m_Generation != lastGeneration; } );
+            if( m_IsShuttingDown ) { return; }
+            lastGeneration = m_Generation;
+        }
+
+        RunJobIndices();
+
+        bool isLastWorker = false;
+        {
+            std::lock_guard<std::mutex> lock( m_Mutex );
+            isLastWorker = --m_NumBusyWorkers == 0;
+        }
+        if( isLastWorker )
+        {
+            m_WorkDone.notify_one();
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void ThreadPool::RunJobIndices()
+{
+    for( int index = m_NextIndex++; index < m_JobCount; index = m_NextIndex++ )
+    {
+        (*m_Job)( index );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// Workers that sleep between parallel for loops. The calling thread works on
+// the loop too, so a pool with no workers runs everything in place.
+class ThreadPool
+{
+public:
+    explicit ThreadPool( int numWorkers );
+    ~ThreadPool();
+
+    int GetNumWorkers() const           { return static_cast<int>(m_Workers.size()); }
+    // 1 to GetNumWorkers() on a worker, 0 on any thread outside the pool
+    static int GetCurrentThreadIndex();
+
+    // Calls job once for every index in [0, count) and returns when all are
+    // done. Indices are handed out in order but may finish in any order.
+    void ParallelFor( int count, const std::function<void( int )>& job );
+
+private:
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::condition_variable m_WorkDone;
+    int m_Generation = 0;                   // Bumped for every ParallelFor
+    int m_NumBusyWorkers = 0;
+    bool m_IsShuttingDown = false;
+
+    const std::function<void( int )>* m_Job = nullptr;
+    int m_JobCount = 0;
+    std::atomic<int> m_NextIndex;
+
+    void WorkerMain( int threadIndex );
+    void RunJobIndices();
+};
\ No newline at end of file
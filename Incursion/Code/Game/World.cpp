@@ -21,11 +21,19 @@ void World::Create()
 void World::Update( float deltaSeconds )
 {
     m_CurrentMap->Update( deltaSeconds );
+
+    // Maps are completed from inside their own update, so the one left
+    // behind is only released once that update is over
+    if( m_CompletedMap != nullptr )
+    {
+        ReleaseMap( m_CompletedMap );
+        m_CompletedMap = nullptr;
+    }
 }
 
-void World::Render() const
+void World::Render( const AABB2& viewBounds ) const
 {
-    m_CurrentMap->Render();
+    m_CurrentMap->Render( viewBounds );
 }
 
 void World::DebugRender() const
@@ -78,6 +86,8 @@ void World::MapCompleted()
     }
     else
     {
+        // Maps are played in order, the completed one is never returned to
+        m_CompletedMap = m_CurrentMap;
         m_CurrentMap = m_Maps[ m_CurrentMapIndex ];
         m_PlayerCharacter->TeleportToNewMap( m_CurrentMap );
         m_CurrentMap->AddEntityToMapAtStart( m_PlayerCharacter );
@@ -85,6 +95,22 @@ void World::MapCompleted()
 
 }
 
+// Cost doesn't depend on how much was spawned on the map, its tiles and
+// entities go back with its arena and pools
+void World::ReleaseMap( Map* mapToRelease )
+{
+    for( int mapIndex = 0; mapIndex < m_Maps.size(); ++mapIndex )
+    {
+        if( m_Maps[ mapIndex ] == mapToRelease )
+        {
+            m_Maps[ mapIndex ] = nullptr;
+        }
+    }
+
+    mapToRelease->Destroy();
+    delete mapToRelease;
+}
+
 void World::GenerateMaps()
 {
     static IntVec2 mapSizes[ NUM_MAPS ] = { IntVec2( 20,20 ), IntVec2( 40,20 ), IntVec2( 25,40 ) };
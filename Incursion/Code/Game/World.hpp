@@ -2,6 +2,7 @@
 
 #include <vector>
 
+#include "Engine/Core/Math/Primatives/AABB2.hpp"
 #include "Engine/Core/Math/Primatives/IntVec2.hpp"
 
 class Game;
@@ -16,11 +17,12 @@ public:
 
     void Create();
     void Update( float deltaSeconds );
-    void Render() const;
+    void Render( const AABB2& viewBounds ) const;
     void DebugRender() const;
     void Destory();
 
     const Map* GetCurrentMap() const { return m_CurrentMap; }
+    Map* GetCurrentMap() { return m_CurrentMap; }
 
     const PlayerCharacter* GetPlayerCharacter() const;
     const IntVec2 GetCurrentMapSize() const;
@@ -34,8 +36,10 @@ private:
     std::vector<Map*> m_Maps;
     int m_CurrentMapIndex = 0;
     Map* m_CurrentMap = nullptr;
+    Map* m_CompletedMap = nullptr;
 
     PlayerCharacter* m_PlayerCharacter = nullptr;
 
     void GenerateMaps();
+    void ReleaseMap( Map* mapToRelease );
 };
\ No newline at end of file